@@ -0,0 +1,234 @@
+/**
+ * @file app.h
+ * @brief Główna pętla programu obsługująca stos scen (wątek logiki).
+ *
+ * Jedna pętla odbiera zdarzenia wejścia i okna ze wspólnej kolejki. Zdarzenie trafia
+ * do sceny na szczycie stosu, po czym stan scen jest publikowany jako migawka dla
+ * wątku rysowania (render.h), który rysuje klatki w takt zegara klatek niezależnie od
+ * tej pętli. Pętla nie odbiera taktów zegara, więc budzi się tylko na zdarzenia.
+ * Wyniki usługi rozwiązywania (service.h) przychodzą tą samą kolejką i trafiają do
+ * gry niezależnie od sceny na szczycie stosu.
+ * Kolejne ruchy myszy są łączone w jeden (ostatnia pozycja, zsumowane przesunięcia).
+ *
+ * Gdy okno traci fokus, jest minimalizowane lub system wstrzymuje rysowanie, program
+ * przechodzi w tryb tła: zegar klatek jest zatrzymywany (nic nie jest rysowane ani
+ * sprawdzane), zegar gry stoi, a oba wątki budzą się tylko na zdarzenia systemu.
+ * Odsłonięte okno jest odrysowywane raz na zdarzenie ALLEGRO_EVENT_DISPLAY_EXPOSE.
+ *
+ * Czas od startu programu do pierwszej klatki, liczby narysowanych klatek, pominiętych
+ * taktów i połączonych zdarzeń oraz liczba wybudzeń obu wątków na sekundę w obu trybach
+ * są wypisywane na stderr.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <allegro5/allegro5.h>
+
+#include "scene.h"
+#include "menu.h"
+#include "game.h"
+#include "setting.h"
+#include "render.h"
+#include "service.h"
+
+#ifndef APP
+#define APP
+
+/**
+ * @struct AppStats
+ * @brief Liczniki pętli zdarzeń.
+ */
+struct AppStats {
+    long long merged_moves;     ///< Ruchy myszy połączone z następnymi.
+    long long wakeups[2];       ///< Zdarzenia odebrane z kolejki (aktywne okno, tło).
+    double seconds[2];          ///< Czas spędzony w trybie (aktywne okno, tło).
+    double since;               ///< Początek bieżącego trybu (al_get_time).
+};
+
+/**
+ * @brief Liczniki pętli zdarzeń programu.
+ */
+struct AppStats app_stats;
+
+/**
+ * @brief Czy program jest w trybie tła (okno bez fokusu, zminimalizowane lub bez rysowania).
+ */
+bool app_background;
+
+/**
+ * @brief Łączy ruch myszy z ruchami czekającymi bezpośrednio za nim w kolejce.
+ *
+ * @param queue Kolejka zdarzeń.
+ * @param event Zdarzenie ALLEGRO_EVENT_MOUSE_AXES; po powrocie ma ostatnią pozycję
+ * i sumę przesunięć.
+ */
+static void app_merge_moves(ALLEGRO_EVENT_QUEUE* queue, ALLEGRO_EVENT* event)
+{
+    ALLEGRO_EVENT next;
+    while (al_peek_next_event(queue, &next) && next.type == ALLEGRO_EVENT_MOUSE_AXES) {
+        next.mouse.dx += event->mouse.dx;
+        next.mouse.dy += event->mouse.dy;
+        next.mouse.dz += event->mouse.dz;
+        next.mouse.dw += event->mouse.dw;
+        *event = next;
+        al_drop_next_event(queue);
+        app_stats.merged_moves++;
+    }
+}
+
+/**
+ * @brief Przekazuje zdarzenie scenie.
+ */
+static void app_event(int scene, const ALLEGRO_EVENT* event)
+{
+    switch (scene) {
+    case SCENE_MENU: menu_event(event); break;
+    case SCENE_GAME: game_event(event); break;
+    case SCENE_SETTING: setting_event(event); break;
+    }
+}
+
+/**
+ * @brief Powiadamia scenę na szczycie, że scena nad nią została zdjęta.
+ */
+static void app_resume(int popped)
+{
+    switch (scene_top()) {
+    case SCENE_MENU: menu_resume(); break;
+    case SCENE_GAME: game_resume(popped == SCENE_SETTING && setting_scene.accepted); break;
+    }
+}
+
+/**
+ * @brief Przełącza tryb tła: zatrzymuje lub wznawia zegar klatek, zegar gry i wątek rysowania.
+ *
+ * @param background true – okno przeszło w tło, false – wróciło na pierwszy plan.
+ */
+static void app_set_background(bool background)
+{
+    if (background == app_background)
+        return;
+    double now = al_get_time();
+    app_stats.seconds[app_background] += now - app_stats.since;
+    app_stats.since = now;
+    app_background = background;
+
+    game_focus(!background);
+    render_publish();
+    if (background)
+        al_stop_timer(scenes.frame);
+    else
+        al_resume_timer(scenes.frame);
+    render_command(background ? RENDER_BACKGROUND : RENDER_FOREGROUND);
+}
+
+/**
+ * @brief Wypisuje liczbę wybudzeń obu wątków na sekundę w obu trybach (po render_stop).
+ */
+static void app_print_wakeups(void)
+{
+    const char* names[2] = { "foreground", "background" };
+    app_stats.seconds[app_background] += al_get_time() - app_stats.since;
+    for (int i = 0; i < 2; i++) {
+        double seconds = app_stats.seconds[i];
+        long long wakeups = app_stats.wakeups[i] + render.wakeups[i];
+        fprintf(stderr, "Wakeups in %s: %lld in %.1f s (%.2f/s; logic %lld, render %lld)\n", names[i], wakeups, seconds,
+            seconds > 0 ? wakeups / seconds : 0.0, app_stats.wakeups[i], render.wakeups[i]);
+    }
+}
+
+/**
+ * @brief Zamyka wszystkie sceny przy zamknięciu okna (gra jest zapisywana).
+ */
+static void app_close(void)
+{
+    while (scenes.count > 0) {
+        if (scene_top() == SCENE_GAME)
+            game_leave(true);
+        else
+            scene_pop();
+    }
+}
+
+/**
+ * @brief Uruchamia program od menu i obsługuje zdarzenia aż do zamknięcia okna.
+ *
+ * @param display Okno.
+ * @param event_queue Wspólna kolejka zdarzeń.
+ */
+void app_run(ALLEGRO_DISPLAY* display, ALLEGRO_EVENT_QUEUE* event_queue)
+{
+    ALLEGRO_EVENT event;
+
+    scenes_init(display, event_queue);
+
+    // Reszta zasobów wczytuje się w tle, gdy menu jest już widoczne
+    scenes_load();
+    menu_enter();
+    solve_start(event_queue);
+    render_start(display);
+    app_stats.since = al_get_time();
+
+    while (scenes.count > 0)
+    {
+        al_wait_for_event(event_queue, &event);
+        app_stats.wakeups[app_background]++;
+
+        if (event.type == ALLEGRO_EVENT_MOUSE_AXES)
+            app_merge_moves(event_queue, &event);
+
+        // Tryb tła: okno bez fokusu lub system wstrzymał rysowanie (okno zminimalizowane)
+        if (event.type == ALLEGRO_EVENT_DISPLAY_SWITCH_OUT || event.type == ALLEGRO_EVENT_DISPLAY_SWITCH_IN) {
+            app_set_background(event.type == ALLEGRO_EVENT_DISPLAY_SWITCH_OUT);
+            continue;
+        }
+        if (event.type == ALLEGRO_EVENT_DISPLAY_HALT_DRAWING) {
+            app_set_background(true);
+            render_command(RENDER_HALT);
+            continue;
+        }
+        if (event.type == ALLEGRO_EVENT_DISPLAY_RESUME_DRAWING) {
+            render_command(RENDER_RESUME);
+            app_set_background(false);
+            continue;
+        }
+        // Odsłonięte okno w tle jest odrysowywane raz (na pierwszym planie robi to takt klatki)
+        if (event.type == ALLEGRO_EVENT_DISPLAY_EXPOSE) {
+            if (app_background)
+                render_command(RENDER_REDRAW);
+            continue;
+        }
+
+        // Wynik usługi rozwiązywania (gra pomija wyniki dla nieaktualnej planszy)
+        if (event.type == SOLVE_EVENT) {
+            game_solved((const struct SolveResult*)event.user.data1);
+            al_unref_user_event(&event.user);
+            render_publish();
+            continue;
+        }
+
+        // Zdarzenie zamknięcia okna
+        if (event.type == ALLEGRO_EVENT_DISPLAY_CLOSE) {
+            app_close();
+            break;
+        }
+
+        scenes.popped = -1;
+        app_event(scene_top(), &event);
+        if (scenes.popped >= 0 && scenes.count > 0)
+            app_resume(scenes.popped);
+
+        // Stan po zdarzeniu trafia do wątku rysowania
+        render_publish();
+    }
+    render_stop();
+    solve_stop();
+    fprintf(stderr, "Frames: %lld drawn, %lld late ticks dropped, %lld mouse moves merged\n",
+        render.frames_drawn, render.dropped_ticks, app_stats.merged_moves);
+    app_print_wakeups();
+    scenes_destroy();
+    loader_stop();
+}
+
+#endif
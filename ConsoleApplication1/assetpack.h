@@ -0,0 +1,313 @@
+/**
+ * @file assetpack.h
+ * @brief Pakowanie zasobów do archiwum assets.zip i generowanie manifestu.
+ *
+ * Polecenie: --pack-assets <katalog> <assets.zip> [<assets_manifest.h>]
+ *
+ * Zbiera pliki z podkatalogów image/ i sounds/, czcionkę oraz obrazy przeskalowane
+ * przez --transcode (ASSETS_SIZED_DIR), sortuje ścieżki i zapisuje je bez kompresji
+ * (metoda "stored") do archiwum ZIP, które PhysFS czyta bezpośrednio z pamięci.
+ * Opcjonalnie zapisuje manifest: identyfikator każdego zasobu powstaje ze ścieżki
+ * bez pierwszego katalogu i rozszerzenia (image/numbers/1.png → ASSET_NUMBERS_1).
+ * Obrazy przeskalowane są wariantami zasobów z manifestu, więc do niego nie trafiają.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <allegro5/allegro5.h>
+
+#include "assets.h"
+
+#ifndef ASSETPACK
+#define ASSETPACK
+
+/**
+ * @brief Maksymalna liczba pakowanych plików.
+ */
+#define ASSETPACK_MAX 256
+
+/**
+ * @brief Katalogi i pliki pakowane do archiwum (względem katalogu źródłowego).
+ *
+ * Brak zasobu z manifestu przerywa pakowanie; obrazów przeskalowanych może nie być
+ * (--pack-assets bez wcześniejszego --transcode).
+ */
+static const struct {
+    const char* path;       ///< Ścieżka względem katalogu źródłowego.
+    bool required;          ///< Czy brak przerywa pakowanie.
+} assetpack_roots[] = { { "image", true }, { "sounds", true }, { "Tenada.ttf", true }, { ASSETS_SIZED_DIR, false } };
+
+/**
+ * @struct AssetPack
+ * @brief Zebrane ścieżki zasobów.
+ */
+struct AssetPack {
+    char* path[ASSETPACK_MAX];      ///< Ścieżki względne z separatorem '/'.
+    int count;                      ///< Liczba plików.
+    bool overflow;                  ///< Plików było więcej niż ASSETPACK_MAX lub zabrakło pamięci.
+    size_t prefix;                  ///< Długość ścieżki katalogu źródłowego z separatorem.
+};
+
+/**
+ * @brief Dodaje plik do listy (ścieżka względem katalogu źródłowego).
+ */
+static void assetpack_add(struct AssetPack* pack, const char* full)
+{
+    if (strlen(full) <= pack->prefix)
+        return;
+    size_t length = strlen(full + pack->prefix);
+    char* path = pack->count < ASSETPACK_MAX ? (char*)malloc(length + 1) : NULL;
+    if (!path) {
+        pack->overflow = true;
+        return;
+    }
+    memcpy(path, full + pack->prefix, length + 1);
+    for (char* c = path; *c; c++)
+        if (*c == '\\')
+            *c = '/';
+    pack->path[pack->count++] = path;
+}
+
+/**
+ * @brief Wywołanie zwrotne al_for_each_fs_entry: dodaje pliki, wchodzi do katalogów.
+ */
+static int assetpack_visit(ALLEGRO_FS_ENTRY* entry, void* extra)
+{
+    if (!(al_get_fs_entry_mode(entry) & ALLEGRO_FILEMODE_ISDIR))
+        assetpack_add((struct AssetPack*)extra, al_get_fs_entry_name(entry));
+    return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+/**
+ * @brief Porównanie ścieżek dla qsort.
+ */
+static int assetpack_compare(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * @brief Zwraca sumę kontrolną CRC-32 (wielomian ZIP).
+ */
+static uint32_t assetpack_crc32(const unsigned char* data, size_t size)
+{
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Zapisuje liczbę 16- lub 32-bitową w kolejności little-endian.
+ */
+static void assetpack_put(FILE* file, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        fputc((int)((value >> (8 * i)) & 0xFF), file);
+}
+
+/**
+ * @brief Zapisuje nagłówek pliku ZIP (lokalny lub katalogu centralnego).
+ */
+static void assetpack_header(FILE* file, bool central, const char* name, uint32_t crc, uint32_t size, uint32_t offset)
+{
+    assetpack_put(file, central ? 0x02014B50u : 0x04034B50u, 4);
+    if (central)
+        assetpack_put(file, 20, 2);         // Wersja, która utworzyła plik
+    assetpack_put(file, 20, 2);             // Wersja potrzebna do odczytu
+    assetpack_put(file, 0, 2);              // Flagi
+    assetpack_put(file, 0, 2);              // Metoda: bez kompresji
+    assetpack_put(file, 0, 2);              // Czas
+    assetpack_put(file, 0x21, 2);           // Data: 1980-01-01
+    assetpack_put(file, crc, 4);
+    assetpack_put(file, size, 4);           // Rozmiar skompresowany
+    assetpack_put(file, size, 4);           // Rozmiar oryginalny
+    assetpack_put(file, (uint32_t)strlen(name), 2);
+    assetpack_put(file, 0, 2);              // Pole dodatkowe
+    if (central) {
+        assetpack_put(file, 0, 2);          // Komentarz
+        assetpack_put(file, 0, 2);          // Numer dysku
+        assetpack_put(file, 0, 2);          // Atrybuty wewnętrzne
+        assetpack_put(file, 0, 4);          // Atrybuty zewnętrzne
+        assetpack_put(file, offset, 4);     // Położenie nagłówka lokalnego
+    }
+    fwrite(name, 1, strlen(name), file);
+}
+
+/**
+ * @brief Tworzy identyfikator zasobu ze ścieżki.
+ */
+static void assetpack_id(const char* path, char* id, size_t size)
+{
+    const char* name = strchr(path, '/') ? strchr(path, '/') + 1 : path;
+    const char* dot = strrchr(name, '.');
+    size_t n = snprintf(id, size, "ASSET_");
+    for (const char* c = name; *c && c != dot && n + 1 < size; c++) {
+        char ch = isalnum((unsigned char)*c) ? (char)toupper((unsigned char)*c) : '_';
+        if (ch == '_' && id[n - 1] == '_')
+            continue;
+        id[n++] = ch;
+    }
+    while (id[n - 1] == '_')
+        n--;
+    id[n] = '\0';
+}
+
+/**
+ * @brief Zapisuje manifest zasobów (X-makro ASSET_MANIFEST).
+ */
+static bool assetpack_manifest(const struct AssetPack* pack, const char* out)
+{
+    FILE* file = fopen(out, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s for writing.\n", out);
+        return false;
+    }
+    fprintf(file, "/**\n * @file assets_manifest.h\n * @brief Manifest zasobów archiwum assets.zip.\n *\n");
+    fprintf(file, " * Plik wygenerowany poleceniem --pack-assets (assetpack.h) – nie edytować ręcznie.\n */\n\n");
+    fprintf(file, "#ifndef ASSETS_MANIFEST\n#define ASSETS_MANIFEST\n\n");
+    fprintf(file, "/**\n * @brief Zasoby w kolejności archiwum: X(identyfikator, ścieżka).\n */\n");
+    fprintf(file, "#define ASSET_MANIFEST(X) \\\n");
+    // Warianty przeskalowane nie dostają identyfikatorów
+    int listed[ASSETPACK_MAX], count = 0;
+    for (int i = 0; i < pack->count; i++)
+        if (strncmp(pack->path[i], ASSETS_SIZED_DIR "/", strlen(ASSETS_SIZED_DIR) + 1) != 0)
+            listed[count++] = i;
+
+    bool ok = true;
+    char id[128], previous[128] = "";
+    for (int i = 0; i < count; i++) {
+        const char* path = pack->path[listed[i]];
+        assetpack_id(path, id, sizeof(id));
+        for (int j = 0; j < i; j++) {
+            assetpack_id(pack->path[listed[j]], previous, sizeof(previous));
+            if (strcmp(id, previous) == 0) {
+                fprintf(stderr, "Duplicate asset id %s: %s, %s\n", id, pack->path[listed[j]], path);
+                ok = false;
+            }
+        }
+        fprintf(file, "    X(%s, \"%s\")%s\n", id, path, i + 1 < count ? " \\" : "");
+    }
+    fprintf(file, "\n#endif\n");
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * @brief Punkt wejścia pakowania zasobów (--pack-assets).
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int assetpack_main(int argc, char** argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s --pack-assets <dir> <assets.zip> [<assets_manifest.h>]\n", argv[0]);
+        return 1;
+    }
+    struct AssetPack pack;
+    memset(&pack, 0, sizeof(pack));
+    pack.prefix = strlen(argv[2]) + 1;
+
+    char path[1024];
+    bool complete = true;
+    for (size_t i = 0; i < sizeof(assetpack_roots) / sizeof(*assetpack_roots); i++) {
+        snprintf(path, sizeof(path), "%s/%s", argv[2], assetpack_roots[i].path);
+        ALLEGRO_FS_ENTRY* entry = al_create_fs_entry(path);
+        if (!entry || !al_fs_entry_exists(entry)) {
+            if (assetpack_roots[i].required) {
+                fprintf(stderr, "Missing %s\n", path);
+                complete = false;
+            }
+        }
+        else if (al_get_fs_entry_mode(entry) & ALLEGRO_FILEMODE_ISDIR)
+            al_for_each_fs_entry(entry, assetpack_visit, &pack);
+        else
+            assetpack_add(&pack, path);
+        if (entry)
+            al_destroy_fs_entry(entry);
+    }
+    if (pack.overflow) {
+        fprintf(stderr, "Too many assets (at most %d) or out of memory.\n", ASSETPACK_MAX);
+        complete = false;
+    }
+    // Niepełne archiwum nie jest zapisywane – program czytałby je zamiast luźnych plików
+    FILE* file = complete ? fopen(argv[3], "wb") : NULL;
+    if (complete && !file)
+        fprintf(stderr, "Unable to open %s for writing.\n", argv[3]);
+    if (!file) {
+        for (int i = 0; i < pack.count; i++)
+            free(pack.path[i]);
+        return 1;
+    }
+    qsort(pack.path, pack.count, sizeof(*pack.path), assetpack_compare);
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    // Pliki lokalne w kolejności manifestu, potem katalog centralny
+    uint32_t crc[ASSETPACK_MAX], size[ASSETPACK_MAX], offset[ASSETPACK_MAX];
+    bool ok = true;
+    for (int i = 0; i < pack.count && ok; i++) {
+        snprintf(path, sizeof(path), "%s/%s", argv[2], pack.path[i]);
+        FILE* in = fopen(path, "rb");
+        ok = in != NULL;
+        if (!ok) {
+            fprintf(stderr, "Unable to open %s.\n", path);
+            break;
+        }
+        fseek(in, 0, SEEK_END);
+        long length = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        unsigned char* data = (unsigned char*)malloc(length > 0 ? (size_t)length : 1);
+        ok = data && fread(data, 1, (size_t)length, in) == (size_t)length;
+        fclose(in);
+        if (ok) {
+            crc[i] = assetpack_crc32(data, (size_t)length);
+            size[i] = (uint32_t)length;
+            offset[i] = (uint32_t)ftell(file);
+            assetpack_header(file, false, pack.path[i], crc[i], size[i], 0);
+            fwrite(data, 1, (size_t)length, file);
+        }
+        free(data);
+    }
+    uint32_t directory = (uint32_t)ftell(file);
+    for (int i = 0; i < pack.count && ok; i++)
+        assetpack_header(file, true, pack.path[i], crc[i], size[i], offset[i]);
+    uint32_t end = (uint32_t)ftell(file);
+    assetpack_put(file, 0x06054B50u, 4);
+    assetpack_put(file, 0, 2);                          // Numer dysku
+    assetpack_put(file, 0, 2);                          // Dysk katalogu centralnego
+    assetpack_put(file, (uint32_t)pack.count, 2);
+    assetpack_put(file, (uint32_t)pack.count, 2);
+    assetpack_put(file, end - directory, 4);
+    assetpack_put(file, directory, 4);
+    assetpack_put(file, 0, 2);                          // Komentarz
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "Unable to write %s.\n", argv[3]);
+        remove(argv[3]);
+    }
+
+    if (ok && argc > 4)
+        ok = assetpack_manifest(&pack, argv[4]);
+    if (ok)
+        printf("Packed %d assets (%u bytes) into %s\n", pack.count, end + 22, argv[3]);
+    for (int i = 0; i < pack.count; i++)
+        free(pack.path[i]);
+    return ok ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file assets.h
+ * @brief Zasoby gry adresowane identyfikatorami z manifestu i czytane przez PhysFS.
+ *
+ * Obrazy, czcionka i muzyka leżą w jednym archiwum assets.zip obok pliku programu
+ * (pliki zapisane bez kompresji, w kolejności manifestu). Archiwum jest mapowane do
+ * pamięci i montowane w PhysFS, a wszystkie odczyty Allegro (al_load_bitmap,
+ * al_load_audio_stream, al_fopen) przechodzą przez interfejs plików PhysFS. Program nie
+ * zależy więc od katalogu roboczego i przy starcie otwiera jeden plik zamiast
+ * kilkudziesięciu.
+ *
+ * Luźne pliki z katalogu roboczego są montowane przed archiwum, gdy ustawiona jest
+ * zmienna środowiskowa ASSETS_LOOSE_ENV (zmieniony obraz jest widoczny bez pakowania),
+ * oraz gdy archiwum nie istnieje.
+ *
+ * Identyfikatory zasobów pochodzą z pliku assets_manifest.h, który wraz z archiwum
+ * tworzy polecenie --pack-assets (assetpack.h).
+ *
+ * Obrazy przeskalowane wcześniej do rozmiaru rysowania (polecenie --transcode,
+ * transcode.h) leżą w katalogu ASSETS_SIZED_DIR/<szerokość okna>/ i mają
+ * pierwszeństwo przed oryginałami.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <physfs.h>
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_physfs.h>
+
+#include "mapfile.h"
+#include "assets_manifest.h"
+
+#ifndef ASSETS
+#define ASSETS
+
+/**
+ * @brief Nazwa archiwum zasobów.
+ */
+#define ASSETS_FILE "assets.zip"
+
+/**
+ * @brief Zmienna środowiskowa, która montuje luźne pliki z katalogu roboczego przed archiwum
+ * (dowolna niepusta wartość poza "0").
+ */
+#define ASSETS_LOOSE_ENV "SUDOKU_LOOSE_ASSETS"
+
+/**
+ * @brief Katalog obrazów przeskalowanych dla rozdzielczości okna.
+ */
+#define ASSETS_SIZED_DIR "transcoded"
+
+/**
+ * @brief Formaty przeskalowanych obrazów w kolejności sprawdzania.
+ */
+static const char* const asset_sized_formats[] = { ".tga", ".webp", ".png" };
+
+/**
+ * @brief Identyfikatory zasobów (kolejność manifestu).
+ */
+enum AssetId {
+#define ASSET_ID(id, path) id,
+    ASSET_MANIFEST(ASSET_ID)
+#undef ASSET_ID
+    ASSET_COUNT             ///< Liczba zasobów.
+};
+
+/**
+ * @brief Ścieżki zasobów w archiwum według identyfikatora.
+ */
+static const char* const asset_paths[ASSET_COUNT] = {
+#define ASSET_PATH(id, path) path,
+    ASSET_MANIFEST(ASSET_PATH)
+#undef ASSET_PATH
+};
+
+/**
+ * @brief Obrazy cyfr 1-9 według cyfry.
+ */
+static const enum AssetId asset_digits[9] = {
+    ASSET_NUMBERS_1, ASSET_NUMBERS_2, ASSET_NUMBERS_3, ASSET_NUMBERS_4, ASSET_NUMBERS_5,
+    ASSET_NUMBERS_6, ASSET_NUMBERS_7, ASSET_NUMBERS_8, ASSET_NUMBERS_9
+};
+
+/**
+ * @struct Assets
+ * @brief Zamontowane źródła zasobów.
+ */
+struct Assets {
+    struct MappedFile archive;      ///< Zmapowane archiwum.
+    bool packed;                    ///< Archiwum jest zamontowane.
+    bool mounted;                   ///< PhysFS jest interfejsem plików Allegro.
+    bool sized;                     ///< Istnieją obrazy przeskalowane (ASSETS_SIZED_DIR).
+};
+
+/**
+ * @brief Źródła zasobów programu.
+ */
+struct Assets assets;
+
+/**
+ * @brief Zwraca ścieżkę zasobu.
+ *
+ * @param id Identyfikator zasobu.
+ * @return Ścieżka w archiwum (i względem katalogu z luźnymi plikami).
+ */
+const char* asset_path(enum AssetId id)
+{
+    return asset_paths[id];
+}
+
+/**
+ * @brief Zwraca ścieżkę obrazu przeskalowanego dla szerokości okna lub oryginału.
+ *
+ * @param id Identyfikator zasobu obrazu.
+ * @param width Szerokość okna.
+ * @param buffer Bufor na ścieżkę.
+ * @param size Rozmiar bufora.
+ * @return Ścieżka do wczytania (buffer albo ścieżka oryginału).
+ */
+const char* asset_sized_path(enum AssetId id, int width, char* buffer, size_t size)
+{
+    const char* path = asset_path(id);
+    if (!assets.sized)
+        return path;
+    const char* dot = strrchr(path, '.');
+    int stem = dot ? (int)(dot - path) : (int)strlen(path);
+    for (size_t i = 0; i < sizeof(asset_sized_formats) / sizeof(*asset_sized_formats); i++) {
+        snprintf(buffer, size, "%s/%d/%.*s%s", ASSETS_SIZED_DIR, width, stem, path, asset_sized_formats[i]);
+        if (al_filename_exists(buffer))
+            return buffer;
+    }
+    return path;
+}
+
+/**
+ * @brief Montuje archiwum zasobów (i luźne pliki) i ustawia interfejs plików PhysFS.
+ *
+ * Interfejs plików Allegro jest ustawieniem wątku, więc wątki czytające zasoby
+ * wywołują assets_use_thread().
+ *
+ * @param argv0 Pierwszy argument programu (wymagany przez PHYSFS_init).
+ * @return false, jeśli nie ma ani archiwum, ani luźnych plików (zasoby czytane są wtedy zwykłym stdio).
+ */
+bool assets_mount(const char* argv0)
+{
+    memset(&assets, 0, sizeof(assets));
+    if (!PHYSFS_init(argv0)) {
+        fprintf(stderr, "PhysFS: %s\n", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+        assets.sized = al_filename_exists(ASSETS_SIZED_DIR);
+        return false;
+    }
+
+    char* cwd = al_get_current_directory();
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s", PHYSFS_getBaseDir(), ASSETS_FILE);
+    bool archive = map_file(path, &assets.archive);
+    if (!archive) {
+        snprintf(path, sizeof(path), "%s/%s", cwd ? cwd : ".", ASSETS_FILE);
+        archive = map_file(path, &assets.archive);
+    }
+
+    // Luźne pliki mają pierwszeństwo przed archiwum (pierwszy punkt montowania wygrywa)
+    const char* override = getenv(ASSETS_LOOSE_ENV);
+    bool loose = !archive || (override && *override && strcmp(override, "0") != 0);
+    if (loose && cwd)
+        loose = PHYSFS_mount(cwd, NULL, 1) != 0;
+    al_free(cwd);
+
+    if (archive) {
+        assets.packed = PHYSFS_mountMemory(assets.archive.data, (PHYSFS_uint64)assets.archive.size, NULL, ASSETS_FILE, NULL, 1) != 0;
+        if (!assets.packed) {
+            fprintf(stderr, "PhysFS: %s: %s\n", ASSETS_FILE, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+            unmap_file(&assets.archive);
+        }
+    }
+    if (!assets.packed && !loose) {
+        PHYSFS_deinit();
+        assets.sized = al_filename_exists(ASSETS_SIZED_DIR);
+        return false;
+    }
+    assets.mounted = true;
+    al_set_physfs_file_interface();
+    assets.sized = al_filename_exists(ASSETS_SIZED_DIR);
+    return true;
+}
+
+/**
+ * @brief Ustawia interfejs plików PhysFS dla bieżącego wątku (po assets_mount).
+ */
+void assets_use_thread(void)
+{
+    if (assets.mounted)
+        al_set_physfs_file_interface();
+}
+
+/**
+ * @brief Odmontowuje zasoby i przywraca standardowy interfejs plików.
+ */
+void assets_unmount(void)
+{
+    if (!assets.mounted)
+        return;
+    al_set_standard_file_interface();
+    PHYSFS_deinit();
+    if (assets.packed)
+        unmap_file(&assets.archive);
+    assets.mounted = false;
+    assets.packed = false;
+}
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file assets_manifest.h
+ * @brief Manifest zasobów archiwum assets.zip.
+ *
+ * Plik wygenerowany poleceniem --pack-assets (assetpack.h) – nie edytować ręcznie.
+ */
+
+#ifndef ASSETS_MANIFEST
+#define ASSETS_MANIFEST
+
+/**
+ * @brief Zasoby w kolejności archiwum: X(identyfikator, ścieżka).
+ */
+#define ASSET_MANIFEST(X) \
+    X(ASSET_TENADA, "Tenada.ttf") \
+    X(ASSET_SLIDER, "image/Slider.png") \
+    X(ASSET_SLIDERBACKGROUND, "image/SliderBackground.png") \
+    X(ASSET_ACCEPT, "image/accept.png") \
+    X(ASSET_BACKGROUND, "image/background.png") \
+    X(ASSET_CANCEL, "image/cancel.png") \
+    X(ASSET_CLUE, "image/clue.png") \
+    X(ASSET_CONTINUE, "image/continue.png") \
+    X(ASSET_EASY, "image/easy.png") \
+    X(ASSET_EXIT, "image/exit.png") \
+    X(ASSET_EXIT_BOX, "image/exit_box.png") \
+    X(ASSET_HARD, "image/hard.png") \
+    X(ASSET_HEART, "image/heart.png") \
+    X(ASSET_ICON_SETTING, "image/icon_setting.png") \
+    X(ASSET_LEFT_ARROW, "image/left_arrow.png") \
+    X(ASSET_MENU_BG, "image/menu_bg.png") \
+    X(ASSET_MID, "image/mid.png") \
+    X(ASSET_NUMBERS_1, "image/numbers/1.png") \
+    X(ASSET_NUMBERS_2, "image/numbers/2.png") \
+    X(ASSET_NUMBERS_3, "image/numbers/3.png") \
+    X(ASSET_NUMBERS_4, "image/numbers/4.png") \
+    X(ASSET_NUMBERS_5, "image/numbers/5.png") \
+    X(ASSET_NUMBERS_6, "image/numbers/6.png") \
+    X(ASSET_NUMBERS_7, "image/numbers/7.png") \
+    X(ASSET_NUMBERS_8, "image/numbers/8.png") \
+    X(ASSET_NUMBERS_9, "image/numbers/9.png") \
+    X(ASSET_NUMBERS_FRAME, "image/numbers/frame.png") \
+    X(ASSET_RESTART, "image/restart.png") \
+    X(ASSET_RESULT_BOX, "image/result_box.png") \
+    X(ASSET_RIGHT_ARROW, "image/right_arrow.png") \
+    X(ASSET_SETTING, "image/setting.png") \
+    X(ASSET_START, "image/start.png") \
+    X(ASSET_SONGS_23_UPGRADE_STATION, "sounds/songs/23.Upgrade_Station.ogg") \
+    X(ASSET_SONGS_IGGY_WALK, "sounds/songs/IGGY_WALK.ogg") \
+    X(ASSET_SONGS_JOJO_S_BIZARRE_ADVENTURE_DIAMOND_IS_UNBREAKABLE_OST_THE_STARDUST_MAN_APPEARS, "sounds/songs/JoJo's Bizarre Adventure_ Diamond is Unbreakable OST - The Stardust Man Appears.ogg") \
+    X(ASSET_SONGS_JOJO_S_BIZARRE_ADVENTURE_STARDUST_CRUSADERS_OST_SETTING_OFF, "sounds/songs/JoJo's Bizarre Adventure_ Stardust Crusaders OST - Setting Off.ogg") \
+    X(ASSET_SONGS_OST_STARDUST_CRUSADERS_WORLD_TRACK_19_TRAVELERS_WHO_REST, "sounds/songs/OST Stardust Crusaders [World] Track 19 - Travelers Who Rest.ogg")
+
+#endif
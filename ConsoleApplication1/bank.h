@@ -0,0 +1,265 @@
+/**
+ * @file bank.h
+ * @brief Bank gotowych plansz w spakowanym pliku mapowanym do pamięci.
+ *
+ * Format pliku bank.dat:
+ * - nagłówek (struct BankHeader) z liczbą i przesunięciem rekordów każdego poziomu,
+ * - rekordy po BANK_RECORD_SIZE bajtów, pogrupowane według poziomu trudności:
+ *   81-bitowa mapa podpowiedzi (11 bajtów), rozwiązanie po 4 bity na cyfrę (41 bajtów)
+ *   i najtrudniejsza potrzebna technika (enum LogicTechnique, 1 bajt).
+ *
+ * Plik jest mapowany do pamięci przy starcie, więc wybór planszy to losowy indeks
+ * w zmapowanym obszarze – bez parsowania i bez generowania. Nieużywane strony
+ * pozostają na dysku.
+ *
+ * Plik tworzy polecenie: --pack <prefiks> <bank.dat> (z plików generatora).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mapfile.h"
+#include "puzzleio.h"
+#include "solver.h"
+#include "generator.h"
+#include "canon.h"
+
+#ifndef BANK
+#define BANK
+
+/**
+ * @brief Domyślna nazwa pliku banku.
+ */
+#define BANK_FILE "bank.dat"
+
+/**
+ * @brief Znacznik pliku banku ("SDKB").
+ */
+#define BANK_MAGIC 0x424B4453u
+
+/**
+ * @brief Wersja formatu pliku banku.
+ */
+#define BANK_VERSION 1u
+
+/**
+ * @brief Rozmiar rekordu planszy w bajtach (11 + 41 + 1).
+ */
+#define BANK_RECORD_SIZE 53
+
+/**
+ * @struct BankHeader
+ * @brief Nagłówek pliku banku z indeksem poziomów.
+ */
+struct BankHeader {
+    uint32_t magic;                     ///< Znacznik pliku.
+    uint32_t version;                   ///< Wersja formatu.
+    uint32_t record_size;               ///< Rozmiar rekordu.
+    uint32_t count[BANK_LEVELS];        ///< Liczba plansz każdego poziomu.
+    uint64_t offset[BANK_LEVELS];       ///< Przesunięcie pierwszego rekordu poziomu od początku pliku.
+};
+
+/**
+ * @struct PuzzleBank
+ * @brief Otwarty bank plansz.
+ */
+struct PuzzleBank {
+    struct MappedFile file;             ///< Zmapowany plik.
+    const struct BankHeader* header;    ///< Nagłówek (NULL, jeśli bank nie jest otwarty).
+};
+
+/**
+ * @brief Bank plansz używany przez grę.
+ */
+struct PuzzleBank puzzle_bank;
+
+/**
+ * @brief Pakuje planszę do rekordu banku.
+ *
+ * @param record Bufor rekordu (BANK_RECORD_SIZE bajtów).
+ * @param puzzle Plansza (0 – pusta komórka).
+ * @param solution Rozwiązanie planszy.
+ * @param rating Najtrudniejsza potrzebna technika.
+ */
+void bank_pack(unsigned char* record, const int puzzle[9][9], const int solution[9][9], int rating)
+{
+    memset(record, 0, BANK_RECORD_SIZE);
+    unsigned char* givens = record;
+    unsigned char* digits = record + 11;
+    for (int i = 0; i < 81; i++) {
+        if (puzzle[i / 9][i % 9])
+            givens[i >> 3] |= (unsigned char)(1u << (i & 7));
+        digits[i >> 1] |= (unsigned char)(solution[i / 9][i % 9] << ((i & 1) * 4));
+    }
+    record[52] = (unsigned char)rating;
+}
+
+/**
+ * @brief Rozpakowuje rekord banku.
+ *
+ * @param record Rekord banku.
+ * @param puzzle Tablica na planszę.
+ * @param solution Tablica na rozwiązanie lub NULL.
+ */
+void bank_unpack(const unsigned char* record, int puzzle[9][9], int solution[9][9])
+{
+    const unsigned char* givens = record;
+    const unsigned char* digits = record + 11;
+    for (int i = 0; i < 81; i++) {
+        int digit = (digits[i >> 1] >> ((i & 1) * 4)) & 0xF;
+        puzzle[i / 9][i % 9] = (givens[i >> 3] >> (i & 7)) & 1 ? digit : 0;
+        if (solution)
+            solution[i / 9][i % 9] = digit;
+    }
+}
+
+/**
+ * @brief Otwiera bank plansz.
+ *
+ * @param bank Bank do otwarcia.
+ * @param path Ścieżka do pliku banku.
+ * @return true, jeśli plik istnieje i ma poprawny nagłówek.
+ */
+bool open_bank(struct PuzzleBank* bank, const char* path)
+{
+    bank->header = NULL;
+    if (!map_file(path, &bank->file))
+        return false;
+
+    const struct BankHeader* header = (const struct BankHeader*)bank->file.data;
+    bool ok = bank->file.size >= sizeof(struct BankHeader) && header->magic == BANK_MAGIC
+        && header->version == BANK_VERSION && header->record_size == BANK_RECORD_SIZE;
+    for (int i = 0; ok && i < BANK_LEVELS; i++)
+        ok = header->offset[i] + (uint64_t)header->count[i] * BANK_RECORD_SIZE <= bank->file.size;
+    if (!ok) {
+        fprintf(stderr, "Invalid puzzle bank %s.\n", path);
+        unmap_file(&bank->file);
+        return false;
+    }
+    bank->header = header;
+    return true;
+}
+
+/**
+ * @brief Zamyka bank plansz.
+ *
+ * @param bank Bank do zamknięcia.
+ */
+void close_bank(struct PuzzleBank* bank)
+{
+    if (bank->header)
+        unmap_file(&bank->file);
+    bank->header = NULL;
+}
+
+/**
+ * @brief Losuje planszę danego poziomu z banku w O(1).
+ *
+ * @param bank Otwarty bank.
+ * @param level Poziom trudności (0 – łatwy, 1 – średni, 2 – trudny).
+ * @param puzzle Tablica na planszę.
+ * @param solution Tablica na rozwiązanie lub NULL.
+ * @return false, jeśli bank nie jest otwarty lub nie ma plansz tego poziomu.
+ */
+bool bank_pick(const struct PuzzleBank* bank, int level, int puzzle[9][9], int solution[9][9])
+{
+    if (!bank->header || level < 0 || level >= BANK_LEVELS || bank->header->count[level] == 0)
+        return false;
+    uint64_t r = ((uint64_t)rand() << 30) ^ ((uint64_t)rand() << 15) ^ (uint64_t)rand();
+    uint64_t index = r % bank->header->count[level];
+    bank_unpack((const unsigned char*)bank->file.data + bank->header->offset[level] + index * BANK_RECORD_SIZE, puzzle, solution);
+    return true;
+}
+
+/**
+ * @brief Punkt wejścia pakowania banku (--pack).
+ *
+ * Czyta pliki <prefiks>_easy.txt, <prefiks>_mid.txt, <prefiks>_hard.txt, rozwiązuje
+ * każdą planszę i zapisuje bank. Plansze bez jednoznacznego rozwiązania oraz plansze
+ * równoważne wcześniej zapisanym (ten sam skrót kanoniczny) są pomijane.
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int bank_main(int argc, char** argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s --pack <prefix> <bank.dat>\n", argv[0]);
+        return 1;
+    }
+    FILE* file = fopen(argv[3], "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s for writing.\n", argv[3]);
+        return 1;
+    }
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    struct BankHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = BANK_MAGIC;
+    header.version = BANK_VERSION;
+    header.record_size = BANK_RECORD_SIZE;
+    fwrite(&header, sizeof(header), 1, file);
+
+    char path[260];
+    int puzzle[9][9], solution[9][9];
+    unsigned char record[BANK_RECORD_SIZE];
+    long long skipped = 0, duplicates = 0;
+    bool out_of_memory = false;
+    struct HashSet set;
+    if (!hashset_create(&set)) {
+        fclose(file);
+        return 1;
+    }
+    uint64_t offset = sizeof(header);
+    for (int level = 0; level < BANK_LEVELS && !out_of_memory; level++) {
+        header.offset[level] = offset;
+        snprintf(path, sizeof(path), "%s_%s.txt", argv[2], bank_level_names[level]);
+        struct PuzzleReader reader;
+        if (!open_puzzles(&reader, path))
+            continue;
+        while (read_puzzle(&reader, puzzle)) {
+            if (count_solutions(puzzle, 2, solution) != 1) {
+                skipped++;
+                continue;
+            }
+            enum HashInsert inserted = hashset_insert(&set, puzzle_hash(puzzle));
+            if (inserted == HASH_NO_MEMORY) {
+                out_of_memory = true;
+                break;
+            }
+            if (inserted == HASH_DUPLICATE) {
+                duplicates++;
+                continue;
+            }
+            bank_pack(record, puzzle, solution, rate_logic(puzzle));
+            fwrite(record, BANK_RECORD_SIZE, 1, file);
+            header.count[level]++;
+            offset += BANK_RECORD_SIZE;
+        }
+        close_puzzles(&reader);
+    }
+
+    // Bez pamięci na zbiór skrótów bank byłby niepełny: nie jest zapisywany
+    if (out_of_memory) {
+        fprintf(stderr, "Out of memory after %zu unique puzzles; %s was not written.\n", set.count, argv[3]);
+        fclose(file);
+        remove(argv[3]);
+        hashset_destroy(&set);
+        return 1;
+    }
+
+    // Nagłówek z uzupełnionym indeksem
+    fseek(file, 0, SEEK_SET);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    hashset_destroy(&set);
+    printf("Packed %u easy, %u mid, %u hard puzzles (%lld skipped, %lld duplicates)\n",
+        header.count[0], header.count[1], header.count[2], skipped, duplicates);
+    return ok ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,423 @@
+/**
+ * @file batch.h
+ * @brief Wielowątkowe rozwiązywanie dużych plików z planszami (tryb wsadowy).
+ *
+ * Plik wejściowy jest mapowany do pamięci i dekodowany do zwartej tablicy (81 bajtów
+ * na planszę). Plansze są dzielone na porcje po BATCH_CHUNK sztuk; każdy wątek dostaje
+ * własną kolejkę ciągłego zakresu porcji, a po jej opróżnieniu podkrada porcje z końca
+ * kolejki najbardziej obciążonego wątku (work stealing). Rozwiązania trafiają do tablicy
+ * wyników pod indeksem planszy, więc plik wyjściowy zachowuje kolejność wejścia.
+ *
+ * Użycie: --solve <wejście> <wyjście> [--threads N] [--backend masks|backtrack] [--scaling]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+
+#include "gensudoku.h"
+#include "solver.h"
+#include "puzzleio.h"
+
+#ifndef BATCH
+#define BATCH
+
+/**
+ * @brief Liczba plansz w jednej porcji pracy.
+ */
+#define BATCH_CHUNK 64
+
+/**
+ * @brief Dostępne algorytmy rozwiązywania.
+ */
+enum SolverBackend {
+    SOLVER_MASKS,       ///< Solver na maskach bitowych (solver.h), wykrywa wiele rozwiązań.
+    SOLVER_BACKTRACK    ///< Dotychczasowy solveSudoku (gensudoku.h).
+};
+
+/**
+ * @brief Wynik rozwiązania jednej planszy.
+ */
+enum BatchStatus {
+    BATCH_UNSOLVABLE = 0,   ///< Brak rozwiązania.
+    BATCH_UNIQUE = 1,       ///< Dokładnie jedno rozwiązanie (lub rozwiązanie znalezione przez backtracking).
+    BATCH_MULTIPLE = 2      ///< Więcej niż jedno rozwiązanie.
+};
+
+/**
+ * @struct BatchQueue
+ * @brief Kolejka porcji jednego wątku: zakres [begin, end) indeksów porcji.
+ */
+struct BatchQueue {
+    ALLEGRO_MUTEX* mutex;   ///< Chroni begin/end.
+    int begin;              ///< Następna porcja właściciela (pobierana z początku).
+    int end;                ///< Koniec zakresu (złodzieje pobierają z końca).
+};
+
+/**
+ * @struct BatchJob
+ * @brief Wspólne dane zadania wsadowego.
+ */
+struct BatchJob {
+    int count;                      ///< Liczba plansz.
+    unsigned char* puzzles;         ///< Plansze, 81 bajtów na planszę.
+    unsigned char* solutions;       ///< Rozwiązania, 81 bajtów na planszę.
+    unsigned char* status;          ///< Wynik dla każdej planszy (BatchStatus).
+    enum SolverBackend backend;     ///< Wybrany solver.
+    int threads;                    ///< Liczba wątków.
+    struct BatchQueue* queues;      ///< Kolejki porcji wątków.
+};
+
+/**
+ * @struct BatchWorker
+ * @brief Dane jednego wątku roboczego.
+ */
+struct BatchWorker {
+    struct BatchJob* job;   ///< Wspólne zadanie.
+    int id;                 ///< Numer wątku.
+    long long solved;       ///< Liczba plansz rozwiązanych przez wątek.
+    int stolen;             ///< Liczba podkradzionych porcji.
+    double busy;            ///< Czas pracy wątku w sekundach.
+};
+
+/**
+ * @brief Wczytuje wszystkie plansze z pliku do zwartej tablicy.
+ *
+ * @param path Ścieżka do pliku wejściowego.
+ * @param count Liczba wczytanych plansz.
+ * @return Tablica plansz (81 bajtów na planszę) lub NULL przy błędzie.
+ */
+unsigned char* load_puzzle_file(const char* path, int* count)
+{
+    struct PuzzleReader reader;
+    *count = 0;
+    if (!open_puzzles(&reader, path))
+        return NULL;
+
+    // Szacowana liczba plansz: około 82 bajtów na planszę
+    int capacity = (int)(reader.file.size / 82) + 16;
+    unsigned char* puzzles = malloc((size_t)capacity * 81);
+    int grid[9][9];
+    while (puzzles && read_puzzle(&reader, grid)) {
+        if (*count == capacity) {
+            capacity *= 2;
+            unsigned char* temp = realloc(puzzles, (size_t)capacity * 81);
+            if (!temp) {
+                free(puzzles);
+                puzzles = NULL;
+                break;
+            }
+            puzzles = temp;
+        }
+        unsigned char* p = puzzles + (size_t)*count * 81;
+        for (int i = 0; i < 81; i++)
+            p[i] = (unsigned char)grid[i / 9][i % 9];
+        (*count)++;
+    }
+    close_puzzles(&reader);
+    return puzzles;
+}
+
+/**
+ * @brief Rozwiązuje jedną planszę wybranym solverem.
+ *
+ * @param backend Wybrany solver.
+ * @param puzzle Plansza (81 bajtów).
+ * @param solution Bufor na rozwiązanie (81 bajtów).
+ * @return Wynik (BatchStatus).
+ */
+static unsigned char batch_solve_one(enum SolverBackend backend, const unsigned char* puzzle, unsigned char* solution)
+{
+    int grid[9][9];
+    int result[9][9];
+    for (int i = 0; i < 81; i++)
+        grid[i / 9][i % 9] = puzzle[i];
+
+    unsigned char status;
+    if (backend == SOLVER_BACKTRACK) {
+        memcpy(result, grid, sizeof(grid));
+        status = solveSudoku(result) ? BATCH_UNIQUE : BATCH_UNSOLVABLE;
+    }
+    else {
+        int n = count_solutions(grid, 2, result);
+        status = n == 0 ? BATCH_UNSOLVABLE : (n == 1 ? BATCH_UNIQUE : BATCH_MULTIPLE);
+    }
+
+    for (int i = 0; i < 81; i++)
+        solution[i] = (unsigned char)(status != BATCH_UNSOLVABLE ? result[i / 9][i % 9] : puzzle[i]);
+    return status;
+}
+
+/**
+ * @brief Pobiera następną porcję: najpierw z własnej kolejki, potem podkrada z innej.
+ *
+ * @param worker Wątek roboczy.
+ * @return Indeks porcji lub -1, jeśli cała praca została rozdzielona.
+ */
+static int batch_next_chunk(struct BatchWorker* worker)
+{
+    struct BatchJob* job = worker->job;
+    struct BatchQueue* own = &job->queues[worker->id];
+    int chunk = -1;
+
+    al_lock_mutex(own->mutex);
+    if (own->begin < own->end)
+        chunk = own->begin++;
+    al_unlock_mutex(own->mutex);
+    if (chunk >= 0)
+        return chunk;
+
+    // Kradzież z końca kolejki z największą liczbą pozostałych porcji
+    while (true) {
+        int victim = -1, most = 0;
+        for (int i = 0; i < job->threads; i++) {
+            al_lock_mutex(job->queues[i].mutex);
+            int left = job->queues[i].end - job->queues[i].begin;
+            al_unlock_mutex(job->queues[i].mutex);
+            if (left > most) {
+                most = left;
+                victim = i;
+            }
+        }
+        if (victim < 0)
+            return -1;
+
+        struct BatchQueue* queue = &job->queues[victim];
+        al_lock_mutex(queue->mutex);
+        if (queue->begin < queue->end)
+            chunk = --queue->end;
+        al_unlock_mutex(queue->mutex);
+        if (chunk >= 0) {
+            worker->stolen++;
+            return chunk;
+        }
+    }
+}
+
+/**
+ * @brief Funkcja wątku roboczego.
+ */
+static void* batch_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    struct BatchWorker* worker = arg;
+    struct BatchJob* job = worker->job;
+    double start = al_get_time();
+    int chunk;
+    while ((chunk = batch_next_chunk(worker)) >= 0) {
+        int first = chunk * BATCH_CHUNK;
+        int last = first + BATCH_CHUNK < job->count ? first + BATCH_CHUNK : job->count;
+        for (int i = first; i < last; i++) {
+            job->status[i] = batch_solve_one(job->backend, job->puzzles + (size_t)i * 81, job->solutions + (size_t)i * 81);
+            worker->solved++;
+        }
+    }
+    worker->busy = al_get_time() - start;
+    return NULL;
+}
+
+/**
+ * @brief Rozwiązuje wszystkie plansze zadania podaną liczbą wątków.
+ *
+ * @param job Zadanie wsadowe (plansze i bufory wyników).
+ * @param threads Liczba wątków.
+ * @param report Czy wypisać statystyki poszczególnych wątków.
+ * @return Czas rozwiązywania w sekundach lub wartość ujemna, gdy zabrakło pamięci.
+ */
+double batch_run(struct BatchJob* job, int threads, bool report)
+{
+    int chunks = (job->count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    job->threads = threads;
+    job->queues = calloc(threads, sizeof(struct BatchQueue));
+    struct BatchWorker* workers = calloc(threads, sizeof(struct BatchWorker));
+    ALLEGRO_THREAD** handles = calloc(threads, sizeof(ALLEGRO_THREAD*));
+    if (!job->queues || !workers || !handles) {
+        fprintf(stderr, "Cannot allocate batch workers.\n");
+        free(job->queues);
+        job->queues = NULL;
+        free(workers);
+        free(handles);
+        return -1.0;
+    }
+
+    // Każdy wątek dostaje ciągły zakres porcji
+    for (int i = 0; i < threads; i++) {
+        job->queues[i].mutex = al_create_mutex();
+        job->queues[i].begin = (int)((long long)chunks * i / threads);
+        job->queues[i].end = (int)((long long)chunks * (i + 1) / threads);
+        workers[i].job = job;
+        workers[i].id = i;
+    }
+
+    double start = al_get_time();
+    for (int i = 0; i < threads; i++) {
+        handles[i] = al_create_thread(batch_worker, &workers[i]);
+        if (handles[i])
+            al_start_thread(handles[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        if (handles[i]) {
+            al_join_thread(handles[i], NULL);
+            al_destroy_thread(handles[i]);
+        }
+    }
+    // Wątki, których nie udało się utworzyć: pozostałe porcje rozwiązuje wątek główny
+    for (int i = 0; i < threads; i++) {
+        if (!handles[i])
+            batch_worker(NULL, &workers[i]);
+    }
+    double elapsed = al_get_time() - start;
+
+    if (report) {
+        for (int i = 0; i < threads; i++)
+            printf("  thread %2d: %lld puzzles, %.0f puzzles/s, %d chunks stolen\n", i, workers[i].solved,
+                workers[i].busy > 0 ? workers[i].solved / workers[i].busy : 0.0, workers[i].stolen);
+    }
+
+    for (int i = 0; i < threads; i++)
+        al_destroy_mutex(job->queues[i].mutex);
+    free(job->queues);
+    job->queues = NULL;
+    free(workers);
+    free(handles);
+    return elapsed;
+}
+
+/**
+ * @brief Zapisuje rozwiązania w kolejności wejścia.
+ *
+ * Plansze bez rozwiązania są zapisywane w oryginalnej postaci z dopiskiem " ;unsolvable",
+ * a plansze z wieloma rozwiązaniami – pierwsze rozwiązanie z dopiskiem " ;multiple".
+ *
+ * @param job Zadanie wsadowe z wynikami.
+ * @param path Ścieżka do pliku wyjściowego.
+ * @return true, jeśli zapis powiódł się.
+ */
+bool batch_write(const struct BatchJob* job, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s for writing.\n", path);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    bool ok = true;
+    char line[96];
+    for (int i = 0; i < job->count && ok; i++) {
+        const unsigned char* cells = job->solutions + (size_t)i * 81;
+        for (int j = 0; j < 81; j++)
+            line[j] = cells[j] ? (char)('0' + cells[j]) : '.';
+        int len = 81;
+        if (job->status[i] == BATCH_UNSOLVABLE) {
+            memcpy(line + len, " ;unsolvable", 12);
+            len += 12;
+        }
+        else if (job->status[i] == BATCH_MULTIPLE) {
+            memcpy(line + len, " ;multiple", 10);
+            len += 10;
+        }
+        line[len++] = '\n';
+        ok = fwrite(line, 1, len, file) == (size_t)len;
+    }
+    if (fclose(file) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "Unable to write %s.\n", path);
+    return ok;
+}
+
+/**
+ * @brief Punkt wejścia trybu wsadowego (--solve).
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int batch_main(int argc, char** argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s --solve <input> <output> [--threads N] [--backend masks|backtrack] [--scaling]\n", argv[0]);
+        return 1;
+    }
+    const char* input = argv[2];
+    const char* output = argv[3];
+    int threads = al_get_cpu_count();
+    bool scaling = false;
+    struct BatchJob job = { 0 };
+    job.backend = SOLVER_MASKS;
+
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+            job.backend = strcmp(argv[++i], "backtrack") == 0 ? SOLVER_BACKTRACK : SOLVER_MASKS;
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+    }
+    if (threads < 1)
+        threads = 1;
+
+    double start = al_get_time();
+    job.puzzles = load_puzzle_file(input, &job.count);
+    if (!job.puzzles) {
+        fprintf(stderr, "Unable to read puzzles from %s.\n", input);
+        return 1;
+    }
+    printf("Loaded %d puzzles in %.3f s\n", job.count, al_get_time() - start);
+
+    job.solutions = malloc((size_t)job.count * 81 + 1);
+    job.status = malloc((size_t)job.count + 1);
+    if (!job.solutions || !job.status) {
+        fprintf(stderr, "Cannot allocate batch results.\n");
+        free(job.puzzles);
+        free(job.solutions);
+        free(job.status);
+        return 1;
+    }
+
+    // Skalowanie: czasy dla 1, 2, 4, ... wątków w porównaniu z jednym wątkiem
+    if (scaling) {
+        double single = 0;
+        for (int n = 1; ; n = n * 2 < threads ? n * 2 : threads) {
+            double elapsed = batch_run(&job, n, false);
+            if (elapsed < 0)
+                break;
+            if (n == 1)
+                single = elapsed;
+            printf("threads %2d: %.3f s, %.0f puzzles/s, efficiency %.0f%%\n", n, elapsed,
+                job.count / elapsed, elapsed > 0 ? 100.0 * single / (n * elapsed) : 100.0);
+            if (n == threads)
+                break;
+        }
+    }
+
+    double elapsed = batch_run(&job, threads, true);
+    if (elapsed < 0) {
+        free(job.puzzles);
+        free(job.solutions);
+        free(job.status);
+        return 1;
+    }
+
+    long long unique = 0, multiple = 0, unsolvable = 0;
+    for (int i = 0; i < job.count; i++) {
+        if (job.status[i] == BATCH_UNIQUE) unique++;
+        else if (job.status[i] == BATCH_MULTIPLE) multiple++;
+        else unsolvable++;
+    }
+    printf("Solved %d puzzles with %d threads in %.3f s\n", job.count, threads, elapsed);
+    printf("Throughput: %.0f puzzles/s total, %.0f puzzles/s per core\n",
+        elapsed > 0 ? job.count / elapsed : 0.0, elapsed > 0 ? job.count / elapsed / threads : 0.0);
+    printf("Unique: %lld, multiple solutions: %lld, unsolvable: %lld\n", unique, multiple, unsolvable);
+
+    bool ok = batch_write(&job, output);
+    free(job.puzzles);
+    free(job.solutions);
+    free(job.status);
+    return ok ? 0 : 1;
+}
+
+#endif
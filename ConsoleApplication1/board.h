@@ -0,0 +1,160 @@
+/**
+ * @file board.h
+ * @brief Maski zajętości jednostek aktualnej planszy gry.
+ *
+ * Dla każdego wiersza, kolumny, kwadratu 3x3 i grupy pozycji (is_poz) przechowywana jest
+ * 9-bitowa maska wpisanych cyfr, aktualizowana przy każdym wpisaniu i usunięciu cyfry.
+ * Sprawdzenie konfliktu proponowanej cyfry i weryfikacja pełnej planszy to kilka operacji
+ * bitowych zamiast rozwiązywania planszy od nowa.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "solver.h"
+
+#ifndef BOARD
+#define BOARD
+
+/**
+ * @struct BoardMasks
+ * @brief Maski cyfr wpisanych w jednostkach planszy.
+ */
+struct BoardMasks {
+    unsigned short row[9];      ///< Cyfry w wierszach.
+    unsigned short col[9];      ///< Cyfry w kolumnach.
+    unsigned short box[9];      ///< Cyfry w kwadratach 3x3.
+    unsigned short pos[9];      ///< Cyfry w grupach pozycji.
+    int filled;                 ///< Liczba wypełnionych komórek.
+};
+
+/**
+ * @brief Wpisuje cyfrę do masek.
+ *
+ * @param m Maski planszy.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Cyfra 1-9.
+ */
+void masks_set(struct BoardMasks* m, int row, int column, int digit)
+{
+    unsigned short bit = (unsigned short)(1u << (digit - 1));
+    m->row[row] |= bit;
+    m->col[column] |= bit;
+    m->box[box_of(row, column)] |= bit;
+    m->pos[pos_of(row, column)] |= bit;
+    m->filled++;
+}
+
+/**
+ * @brief Usuwa cyfrę z masek.
+ *
+ * @param m Maski planszy.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Usuwana cyfra 1-9.
+ */
+void masks_clear(struct BoardMasks* m, int row, int column, int digit)
+{
+    unsigned short bit = (unsigned short)~(1u << (digit - 1));
+    m->row[row] &= bit;
+    m->col[column] &= bit;
+    m->box[box_of(row, column)] &= bit;
+    m->pos[pos_of(row, column)] &= bit;
+    m->filled--;
+}
+
+/**
+ * @brief Sprawdza, czy cyfra koliduje z cyfrą w którejś jednostce komórki.
+ *
+ * @param m Maski planszy.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Proponowana cyfra 1-9.
+ * @return true, jeśli cyfra już występuje w wierszu, kolumnie, kwadracie lub grupie pozycji.
+ */
+bool masks_conflict(const struct BoardMasks* m, int row, int column, int digit)
+{
+    unsigned int used = m->row[row] | m->col[column] | m->box[box_of(row, column)] | m->pos[pos_of(row, column)];
+    return (used >> (digit - 1)) & 1;
+}
+
+/**
+ * @brief Buduje maski dla planszy.
+ *
+ * @param m Maski planszy.
+ * @param grid Plansza (0 – pusta komórka).
+ * @return false, jeśli któraś cyfra powtarza się w wierszu, kolumnie, kwadracie lub grupie pozycji.
+ */
+bool masks_init(struct BoardMasks* m, const int grid[9][9])
+{
+    bool valid = true;
+    memset(m, 0, sizeof(struct BoardMasks));
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++)
+            if (grid[i][j]) {
+                if (masks_conflict(m, i, j, grid[i][j]))
+                    valid = false;
+                masks_set(m, i, j, grid[i][j]);
+            }
+    return valid;
+}
+
+/**
+ * @brief Sprawdza, czy plansza nadaje się do gry według zasad tej gry (z grupami pozycji).
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @return true, jeśli podane cyfry nie kolidują, a plansza ma dokładnie jedno rozwiązanie.
+ */
+bool board_playable(const int grid[9][9])
+{
+    struct BoardMasks m;
+    return masks_init(&m, grid) && count_solutions(grid, 2, NULL) == 1;
+}
+
+/**
+ * @brief Sprawdza, czy plansza jest pełna i poprawna.
+ *
+ * @param m Maski planszy.
+ * @return true, jeśli każda jednostka zawiera wszystkie cyfry 1-9.
+ */
+bool masks_complete(const struct BoardMasks* m)
+{
+    unsigned int all = ALL_DIGITS;
+    for (int i = 0; i < 9; i++)
+        all &= m->row[i] & m->col[i] & m->box[i] & m->pos[i];
+    return m->filled == 81 && all == ALL_DIGITS;
+}
+
+/**
+ * @brief Zaznacza komórki, z którymi koliduje proponowana cyfra.
+ *
+ * Maski wskazują jednostki z konfliktem, a jedno przejście po planszy zaznacza
+ * komórki tych jednostek zawierające tę cyfrę.
+ *
+ * @param m Maski planszy.
+ * @param grid Plansza.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Proponowana cyfra 1-9.
+ * @param cells Tablica flag 81 komórek do wypełnienia.
+ * @return Liczba kolidujących komórek.
+ */
+int masks_conflict_cells(const struct BoardMasks* m, const int grid[9][9], int row, int column, int digit, bool cells[81])
+{
+    unsigned int bit = 1u << (digit - 1);
+    int box = box_of(row, column), pos = pos_of(row, column);
+    bool in_row = m->row[row] & bit, in_col = m->col[column] & bit;
+    bool in_box = m->box[box] & bit, in_pos = m->pos[pos] & bit;
+    int count = 0;
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++) {
+            bool peer = (in_row && i == row) || (in_col && j == column)
+                || (in_box && box_of(i, j) == box) || (in_pos && pos_of(i, j) == pos);
+            cells[i * 9 + j] = peer && grid[i][j] == digit;
+            count += cells[i * 9 + j];
+        }
+    return count;
+}
+
+#endif
@@ -0,0 +1,353 @@
+/**
+ * @file canon.h
+ * @brief Postać kanoniczna i 64-bitowy skrót planszy do usuwania duplikatów.
+ *
+ * Plansze równoważne różnią się przekształceniem, które zachowuje wszystkie cztery
+ * jednostki gry (wiersze, kolumny, kwadraty 3x3 i grupy pozycji z is_poz):
+ * - dowolna permutacja pasów (r / 3) i – wspólna dla wszystkich pasów – permutacja
+ *   wierszy wewnątrz pasa (r % 3); analogicznie dla kolumn i stosów,
+ * - zamiana ról pasa i pozycji w pasie (r = 3b + i -> 3i + b) jednocześnie dla wierszy
+ *   i kolumn, która zamienia kwadraty z grupami pozycji,
+ * - transpozycja,
+ * - zmiana nazw cyfr.
+ * Permutacja wierszy tylko w jednym pasie (jak w klasycznym Sudoku) nie zachowuje
+ * grup pozycji, więc nie należy do grupy.
+ *
+ * Postać kanoniczna to najmniejszy leksykograficznie obraz planszy po wszystkich
+ * 2 * 2 * 36 * 36 przekształceniach geometrycznych, z cyframi numerowanymi w kolejności
+ * pierwszego wystąpienia (0 – pusta komórka). Porównanie przerywane jest przy pierwszej
+ * większej komórce, więc większość przekształceń odpada po kilku komórkach.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <allegro5/allegro5.h>
+
+#include "puzzleio.h"
+#include "batch.h"
+
+#ifndef CANON
+#define CANON
+
+/**
+ * @brief Liczba permutacji linii (pasy x pozycje w pasie).
+ */
+#define CANON_LINES 36
+
+/**
+ * @brief Permutacje zbioru {0, 1, 2}.
+ */
+static const unsigned char canon_perm3[6][3] = {
+    { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 }
+};
+
+/**
+ * @brief Wypełnia tablicę wszystkich permutacji linii (wierszy lub kolumn).
+ *
+ * @param swap Czy zamienić role pasa i pozycji w pasie.
+ * @param lines Tablica na 36 permutacji: lines[t][k] to linia źródłowa linii k.
+ */
+static void canon_lines(int swap, unsigned char lines[CANON_LINES][9])
+{
+    for (int p = 0; p < 6; p++)
+        for (int q = 0; q < 6; q++)
+            for (int k = 0; k < 9; k++) {
+                int band = canon_perm3[p][k / 3], inner = canon_perm3[q][k % 3];
+                lines[p * 6 + q][k] = (unsigned char)(swap ? inner * 3 + band : band * 3 + inner);
+            }
+}
+
+/**
+ * @brief Wyznacza postać kanoniczną planszy.
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @param canon Tablica na postać kanoniczną (81 wartości 0-9, wierszami).
+ */
+void canonicalize(const int grid[9][9], unsigned char canon[81])
+{
+    unsigned char source[2][81];
+    for (int r = 0; r < 9; r++)
+        for (int c = 0; c < 9; c++) {
+            source[0][r * 9 + c] = (unsigned char)grid[r][c];
+            source[1][c * 9 + r] = (unsigned char)grid[r][c];
+        }
+
+    unsigned char lines[CANON_LINES][9];
+    memset(canon, 0xFF, 81);
+    for (int swap = 0; swap < 2; swap++) {
+        canon_lines(swap, lines);
+        for (int t = 0; t < 2; t++) {
+            const unsigned char* g = source[t];
+            for (int a = 0; a < CANON_LINES; a++)
+                for (int b = 0; b < CANON_LINES; b++) {
+                    unsigned char label[10] = { 0 };
+                    unsigned char next = 0;
+                    int order = 0;  // 0 – równe dotąd, -1 – mniejsze (nowe minimum)
+                    for (int k = 0; k < 81; k++) {
+                        unsigned char v = g[lines[a][k / 9] * 9 + lines[b][k % 9]];
+                        if (v) {
+                            if (!label[v])
+                                label[v] = ++next;
+                            v = label[v];
+                        }
+                        if (order == 0) {
+                            if (v > canon[k])
+                                break;
+                            if (v < canon[k])
+                                order = -1;
+                        }
+                        canon[k] = v;
+                    }
+                }
+        }
+    }
+}
+
+/**
+ * @brief Liczy 64-bitowy skrót postaci kanonicznej (FNV-1a z końcowym mieszaniem).
+ *
+ * @param canon Postać kanoniczna.
+ * @return Skrót (nigdy 0).
+ */
+uint64_t canon_hash(const unsigned char canon[81])
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (int k = 0; k < 81; k++) {
+        h ^= canon[k];
+        h *= 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
+
+/**
+ * @brief Liczy skrót planszy niezależny od przekształceń symetrii.
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @return Skrót postaci kanonicznej.
+ */
+uint64_t puzzle_hash(const int grid[9][9])
+{
+    unsigned char canon[81];
+    canonicalize(grid, canon);
+    return canon_hash(canon);
+}
+
+/**
+ * @struct HashSet
+ * @brief Zbiór skrótów z adresowaniem otwartym (0 oznacza wolne miejsce).
+ */
+struct HashSet {
+    uint64_t* keys;     ///< Tablica skrótów.
+    size_t capacity;    ///< Rozmiar tablicy (potęga dwójki).
+    size_t count;       ///< Liczba zapisanych skrótów.
+};
+
+/**
+ * @brief Tworzy pusty zbiór.
+ *
+ * @param set Zbiór do zainicjalizowania.
+ * @return true, jeśli alokacja powiodła się.
+ */
+bool hashset_create(struct HashSet* set)
+{
+    set->capacity = 1 << 16;
+    set->count = 0;
+    set->keys = calloc(set->capacity, sizeof(uint64_t));
+    return set->keys != NULL;
+}
+
+/**
+ * @brief Zwalnia zbiór.
+ *
+ * @param set Zbiór do zniszczenia.
+ */
+void hashset_destroy(struct HashSet* set)
+{
+    free(set->keys);
+    set->keys = NULL;
+    set->capacity = set->count = 0;
+}
+
+/**
+ * @brief Wstawia skrót do tablicy bez sprawdzania zapełnienia.
+ */
+static bool hashset_put(uint64_t* keys, size_t capacity, uint64_t key)
+{
+    size_t i = (size_t)key & (capacity - 1);
+    while (keys[i]) {
+        if (keys[i] == key)
+            return false;
+        i = (i + 1) & (capacity - 1);
+    }
+    keys[i] = key;
+    return true;
+}
+
+/**
+ * @brief Wynik dodania skrótu do zbioru.
+ */
+enum HashInsert {
+    HASH_NEW,           ///< Skrót był nowy i został dodany.
+    HASH_DUPLICATE,     ///< Skrót już był w zbiorze.
+    HASH_NO_MEMORY      ///< Zabrakło pamięci na powiększenie zbioru; skrót nie został dodany.
+};
+
+/**
+ * @brief Dodaje skrót do zbioru.
+ *
+ * @param set Zbiór.
+ * @param key Skrót (różny od 0).
+ * @return HASH_NEW, HASH_DUPLICATE lub HASH_NO_MEMORY.
+ */
+enum HashInsert hashset_insert(struct HashSet* set, uint64_t key)
+{
+    // Powiększenie tablicy przy zapełnieniu powyżej 1/2
+    if ((set->count + 1) * 2 > set->capacity) {
+        uint64_t* keys = calloc(set->capacity * 2, sizeof(uint64_t));
+        if (!keys)
+            return HASH_NO_MEMORY;
+        for (size_t i = 0; i < set->capacity; i++)
+            if (set->keys[i])
+                hashset_put(keys, set->capacity * 2, set->keys[i]);
+        free(set->keys);
+        set->keys = keys;
+        set->capacity *= 2;
+    }
+    if (!hashset_put(set->keys, set->capacity, key))
+        return HASH_DUPLICATE;
+    set->count++;
+    return HASH_NEW;
+}
+
+/**
+ * @struct DedupWorker
+ * @brief Zakres plansz, których skróty liczy jeden wątek.
+ */
+struct DedupWorker {
+    const unsigned char* puzzles;   ///< Plansze, 81 bajtów na planszę.
+    uint64_t* hashes;               ///< Skróty plansz.
+    int begin;                      ///< Pierwsza plansza zakresu.
+    int end;                        ///< Koniec zakresu (wyłącznie).
+};
+
+/**
+ * @brief Wątek liczący skróty plansz ze swojego zakresu.
+ */
+static void* dedup_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    struct DedupWorker* w = arg;
+    int grid[9][9];
+    for (int n = w->begin; n < w->end; n++) {
+        const unsigned char* p = w->puzzles + (size_t)n * 81;
+        for (int i = 0; i < 81; i++)
+            grid[i / 9][i % 9] = p[i];
+        w->hashes[n] = puzzle_hash(grid);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Punkt wejścia usuwania duplikatów (--dedup).
+ *
+ * Skróty kanoniczne liczone są równolegle, a potem jeden przebieg po planszach w kolejności
+ * z pliku zapisuje tylko pierwsze wystąpienie każdej klasy równoważności.
+ * Użycie: --dedup <wejście> <wyjście> [--threads N]
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int dedup_main(int argc, char** argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s --dedup <input> <output> [--threads N]\n", argv[0]);
+        return 1;
+    }
+    int threads = al_get_cpu_count();
+    for (int i = 4; i < argc; i++)
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+    if (threads < 1)
+        threads = 1;
+
+    int count;
+    unsigned char* puzzles = load_puzzle_file(argv[2], &count);
+    if (!puzzles) {
+        fprintf(stderr, "Unable to read puzzles from %s.\n", argv[2]);
+        return 1;
+    }
+    uint64_t* hashes = malloc((size_t)count * sizeof(uint64_t) + 1);
+    struct DedupWorker* workers = calloc(threads, sizeof(struct DedupWorker));
+    ALLEGRO_THREAD** handles = calloc(threads, sizeof(ALLEGRO_THREAD*));
+    struct HashSet set;
+    memset(&set, 0, sizeof(set));
+    // Każde wyjście przechodzi przez wspólne zwalnianie na końcu funkcji
+    bool ok = hashes && workers && handles && hashset_create(&set);
+    if (!ok)
+        fprintf(stderr, "Cannot allocate deduplication buffers.\n");
+
+    double start = al_get_time();
+    if (ok) {
+        for (int i = 0; i < threads; i++) {
+            workers[i] = (struct DedupWorker){ puzzles, hashes,
+                (int)((long long)count * i / threads), (int)((long long)count * (i + 1) / threads) };
+            handles[i] = al_create_thread(dedup_worker, &workers[i]);
+            if (handles[i])
+                al_start_thread(handles[i]);
+        }
+        for (int i = 0; i < threads; i++) {
+            if (handles[i]) {
+                al_join_thread(handles[i], NULL);
+                al_destroy_thread(handles[i]);
+            }
+            else
+                dedup_worker(NULL, &workers[i]);    // Wątku nie udało się utworzyć: jego zakres liczy wątek główny
+        }
+    }
+
+    FILE* file = ok ? fopen(argv[3], "w") : NULL;
+    if (ok && !file) {
+        fprintf(stderr, "Unable to open %s for writing.\n", argv[3]);
+        ok = false;
+    }
+    if (file) {
+        setvbuf(file, NULL, _IOFBF, 1 << 20);
+        int grid[9][9];
+        for (int n = 0; ok && n < count; n++) {
+            enum HashInsert inserted = hashset_insert(&set, hashes[n]);
+            if (inserted == HASH_NO_MEMORY) {
+                fprintf(stderr, "Out of memory after %zu unique puzzles; %s is incomplete.\n", set.count, argv[3]);
+                ok = false;
+                break;
+            }
+            if (inserted == HASH_DUPLICATE)
+                continue;
+            for (int i = 0; i < 81; i++)
+                grid[i / 9][i % 9] = puzzles[(size_t)n * 81 + i];
+            ok = write_puzzle_line(file, grid, '.');
+        }
+        ok = fclose(file) == 0 && ok;
+    }
+    double elapsed = al_get_time() - start;
+
+    if (ok)
+        printf("%d puzzles, %zu unique, %lld duplicates, %d threads, %.0f puzzles/min\n",
+            count, set.count, (long long)count - (long long)set.count, threads,
+            elapsed > 0 ? count * 60.0 / elapsed : 0.0);
+    hashset_destroy(&set);
+    free(handles);
+    free(workers);
+    free(hashes);
+    free(puzzles);
+    return ok ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file cellset.h
+ * @brief Zbiór pustych komórek planszy o stałym rozmiarze.
+ *
+ * Przynależność komórki to bit w 81-bitowej masce, a gęsta tablica indeksów wraz
+ * z odwrotnym odwzorowaniem (komórka -> pozycja) pozwala usuwać komórki przez
+ * zamianę z ostatnią. Dodanie, usunięcie, sprawdzenie i losowy wybór komórki
+ * kosztują O(1), a zbiór nie alokuje pamięci na stercie.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CELLSET
+#define CELLSET
+
+/**
+ * @struct CellSet
+ * @brief Zbiór komórek 0-80.
+ */
+struct CellSet {
+    uint32_t bits[3];       ///< Maska przynależności (bit cell%32 słowa cell/32).
+    uint8_t cells[81];      ///< Komórki zbioru, gęsto od 0 do count-1.
+    uint8_t slot[81];       ///< Pozycja komórki w cells (ważna dla komórek zbioru).
+    int count;              ///< Liczba komórek.
+};
+
+/**
+ * @brief Sprawdza, czy komórka należy do zbioru.
+ *
+ * @param set Zbiór.
+ * @param cell Komórka 0-80.
+ * @return true, jeśli komórka należy do zbioru.
+ */
+bool cellset_contains(const struct CellSet* set, int cell)
+{
+    return (set->bits[cell >> 5] >> (cell & 31)) & 1;
+}
+
+/**
+ * @brief Dodaje komórkę do zbioru.
+ *
+ * @param set Zbiór.
+ * @param cell Komórka 0-80.
+ */
+void cellset_insert(struct CellSet* set, int cell)
+{
+    if (cellset_contains(set, cell))
+        return;
+    set->bits[cell >> 5] |= 1u << (cell & 31);
+    set->slot[cell] = (uint8_t)set->count;
+    set->cells[set->count++] = (uint8_t)cell;
+}
+
+/**
+ * @brief Usuwa komórkę ze zbioru (ostatnia komórka zajmuje jej pozycję).
+ *
+ * @param set Zbiór.
+ * @param cell Komórka 0-80.
+ */
+void cellset_remove(struct CellSet* set, int cell)
+{
+    if (!cellset_contains(set, cell))
+        return;
+    set->bits[cell >> 5] &= ~(1u << (cell & 31));
+    int last = set->cells[--set->count];
+    set->cells[set->slot[cell]] = (uint8_t)last;
+    set->slot[last] = set->slot[cell];
+}
+
+/**
+ * @brief Buduje zbiór pustych komórek planszy.
+ *
+ * @param set Zbiór.
+ * @param grid Plansza (0 – pusta komórka).
+ */
+void cellset_init(struct CellSet* set, const int grid[9][9])
+{
+    memset(set, 0, sizeof(struct CellSet));
+    for (int cell = 0; cell < 81; cell++)
+        if (grid[cell / 9][cell % 9] == 0)
+            cellset_insert(set, cell);
+}
+
+/**
+ * @brief Losuje komórkę zbioru.
+ *
+ * @param set Zbiór.
+ * @return Komórka 0-80 lub -1 dla pustego zbioru.
+ */
+int cellset_random(const struct CellSet* set)
+{
+    return set->count ? set->cells[rand() % set->count] : -1;
+}
+
+#endif
@@ -12,11 +12,6 @@
  */
 #define SIZE_FONT 60                    //Rozmiar czcionki
 
-/**
- * @brief Długość array_zero.
- */
-#define LEN 10
-
 /**
  * @brief Szerokość okna.
  */
@@ -37,10 +32,22 @@ const int resolution[3][2] = { {720, 720}, {900, 900}, {1000, 1000} };	//Tablica
 /**
  * @brief Poziom trudności.
  *
- * Tablica przechowująca poziom trudności gry.
+ * Tablica przechowująca poziom trudności gry. Para wartości identyfikuje poziom
+ * (patrz difficult_level w stats.h); trudność samej planszy wyznacza ocena technik
+ * logicznych (rater.h).
  */
 int difficult[2] = { 0 , 0 };		//Poziom trudności
 
+/**
+ * @brief Liczba wskazówek na grę.
+ */
+#define TOTAL_CLUE 3
+
+/**
+ * @brief Liczba żyć na grę.
+ */
+#define TOTAL_HEARTS 3
+
 /**
  * @brief Poziom głośności.
  */
@@ -20,6 +20,19 @@
 #include "setting.h"
 #include "gensudoku.h"
 #include "sound.h"
+#include "saves.h"
+#include "stats.h"
+#include "bank.h"
+#include "hint.h"
+#include "service.h"
+#include "board.h"
+#include "notes.h"
+#include "journal.h"
+#include "cellset.h"
+#include "stopwatch.h"
+#include "layout.h"
+#include "widget.h"
+#include "scene.h"
 
 
 #include <allegro5/allegro5.h>
@@ -28,8 +41,6 @@
 #include <allegro5/allegro_image.h>
 #include <allegro5/allegro_primitives.h>
 
-#define SAVE_FILE "save.dat"
-
 #ifndef GAME
 #define GAME
 
@@ -40,234 +51,85 @@
 int matrix_area[9][9];
 
 /**
- * @brief Rozmiar tablicy przechowującej planszę Sudoku.
+ * @brief Maski cyfr w wierszach, kolumnach, kwadratach i grupach pozycji planszy matrix_area.
  */
-int size = LEN; // Size of this array_zero
+struct BoardMasks board_masks;
 
 /**
- * @brief Struktura reprezentująca przyciski numeryczne na klawiaturze.
+ * @brief Zbiór pustych komórek planszy Sudoku.
  */
-// Array to store the numpad buttons
-struct NUMPAD numpad[9];
-
-/**
- * @brief Lista przechowująca puste komórki planszy Sudoku.
- */
-// Array to store empty cells
-struct CELL* array_zero = NULL;
+// Set of empty cells
+struct CellSet empty_cells;
 
 
-/**
- * @brief Rozmiar listy przechowującej puste komórki planszy Sudoku.
- */
-int size_array_zero = 0;
-
-
- /**
- * @brief Funkcja zapisująca stan gry do pliku.
- *
- * @param gameState Struktura przechowująca stan gry.
- * @return true, jeśli zapis powiódł się, w przeciwnym razie false.
- */
-// Function of saving game state
-bool save_game(const struct GameState* gameState) {
-    FILE* file = fopen(SAVE_FILE, "wb");
-    if (!file) {
-        fprintf(stderr, "Unable to open save file for writing.\n");
-        return false;
-    }
-    // Write data to file
-    if (fwrite(gameState, sizeof(struct GameState), 1, file) != 1) {
-        fprintf(stderr, "Error writing to save file.\n");
-        fclose(file);
-        return false;
-    }
-    fclose(file);
-    return true;
-}
-
-/**
- * @brief Funkcja wczytująca stan gry z pliku.
- *
- * @param gameState Struktura przechowująca stan gry.
- * @return true, jeśli wczytywanie powiodło się, w przeciwnym razie false.
- */
-// Function of loading the game state
-bool load_game(struct GameState* gameState) {
-    FILE* file = fopen(SAVE_FILE, "rb");
-    if (!file) {
-        fprintf(stderr, "No save file found.\n");
-        return false;
-    }
-    // Read data from the file
-    if (fread(gameState, sizeof(struct GameState), 1, file) != 1) {
-        fprintf(stderr, "Error reading from save file.\n");
-        fclose(file);
-        return false;
-    }
-    fclose(file);
-    return true;
-}
-
-
-/**
- * @brief Funkcja wczytująca stan gry z pliku podczas powrotu z menu.
- *
- * @param gameState Struktura przechowująca stan gry.
- * @return true, jeśli wczytywanie powiodło się, w przeciwnym razie false.
- */
-// Example of the function of loading a game when returning from the menu
-bool load_game_on_menu(struct GameState* gameState) {
-    if (load_game(gameState)) {
-        fprintf(stderr, "Game loaded successfully.\n");
-        return true;
-    }
-    else {
-        fprintf(stderr, "Failed to load the game.\n");
-        return false;
-    }
-}
-
-/**
- * @brief Funkcja zapisująca stan gry do pliku podczas wyjścia do menu.
- *
- * @param gameState Struktura przechowująca stan gry.
- */
-// Example of the function of saving the game when exiting to the menu
-void save_game_on_menu(const struct GameState* gameState) {
-    if (save_game(gameState)) {
-        fprintf(stderr, "Game saved successfully.\n");
-    }
-    else {
-        fprintf(stderr, "Failed to save the game.\n");
-    }
-}
-
 /**
  * @brief Funkcja rysująca siatkę planszy Sudoku.
+ *
+ * @param L Układ ekranu rysowanej klatki.
  */
 // Function to draw the grid
-void draw_area() {
+void draw_area(const struct Layout* L) {
     ALLEGRO_COLOR gridColor = al_map_rgb(0, 0, 0); // Grid color
     ALLEGRO_COLOR sectionColor = al_map_rgb(128, 128, 128); // Section color
 
     // Draw thin gray lines first
     for (int i = 0; i <= 9; ++i) {
-        int x = i * (W / 10.9);
-        int y = i * (H / 11.5);
+        int x = i * L->cell_width;
+        int y = i * L->cell_height;
         if (i % 3 != 0) {
-            al_draw_line(x, 0, x, H / 1.28, sectionColor, 3.0);
-            al_draw_line(0, y, W / 1.2129, y, sectionColor, 3.0);
+            al_draw_line(x, 0, x, L->grid_height, sectionColor, 3.0);
+            al_draw_line(0, y, L->grid_width, y, sectionColor, 3.0);
         }
     }
 
     // Draw thick black lines
     for (int i = 0; i <= 9; i += 3) {
-        int x = i * (W / 10.9);
-        int y = i * (H / 11.5);
-        al_draw_line(x, 0, x, H / 1.28, gridColor, 6.0);
-        al_draw_line(0, y, W / 1.2129, y, gridColor, 6.0);
-    }
-}
-
-/**
- * @brief Funkcja generująca przyciski numeryczne na klawiaturze.
- */
-// Generate numpad buttons
-void generation_numpad() {
-    float width = 0;
-    float height = 0;
-    int k_x = 0;
-    int k_y = 0;
-
-    // Adjust button size based on window size
-    if (resolution[0][0] == W) {
-        width = W / 13;
-        height = H / 13;
-        k_x = 150;
-        k_y = 130;
-        
-    }
-    if (resolution[1][0] == W) {
-        width = W / 12.5;
-        height = H / 12.5;
-        k_x = 160;
-        k_y = 160;
-    }
-    if (resolution[2][0] == W) {
-        width = W / 12;
-        height = H / 12;
-        k_x = 170;
-        k_y = 180;
-    }
-    int j = 0, h = 1;
-    struct NUMPAD temp;
-    
-    for (int i = 0; i < 9; i++) {
-        if (j > 4) { h = 2; j = 1; }
-        char path[50];
-       
-        snprintf(path, sizeof(path), "image/numbers/%d.png", i + 1);
-        temp = (struct NUMPAD){ "", width, height, k_x + j * (width + 20), H - k_y / h, show, i + 1};
-        strcpy(temp.name_file, path);
-        numpad[i] = temp;
-        j++;
+        int x = i * L->cell_width;
+        int y = i * L->cell_height;
+        al_draw_line(x, 0, x, L->grid_height, gridColor, 6.0);
+        al_draw_line(0, y, L->grid_width, y, gridColor, 6.0);
     }
 }
 
 /**
- * @brief Funkcja weryfikująca sukces operacji alokacji dynamicznej pamięci.
+ * @brief Tworzy widżety ekranu gry w kolejności enum GameButton.
  *
- * @param success Sukces operacji alokacji dynamicznej pamięci.
+ * @param widgets Widżety ekranu gry.
  */
-// Function to verify the success of an operation
-void verification(bool success) {
-    if (!success) {
-        fprintf(stderr, "Cannot allocate dynamic variable 'array'\n");
-        exit(1);
-    }
-}
-
-/**
- * @brief Funkcja alokująca pamięć dla tablicy komórek CELL.
- *
- * @param size Rozmiar tablicy komórek CELL.
- * @param array Wskaźnik na tablicę komórek CELL.
- * @return true, jeśli alokacja pamięci powiodła się, w przeciwnym razie false.
- */
-// Allocate memory for CELL array
-bool allocate_array(int size, struct CELL** array) {
-    *array = (struct CELL*)realloc(*array, size * sizeof(struct CELL));
-    return (*array != NULL);
+// Create the game screen widgets once; the index of a widget is its GameButton
+void createGameWidgets(struct Widgets* widgets) {
+    widgets_clear(widgets);
+    for (int i = 0; i < 9; i++)
+        widget_image(widgets, asset_digits[i]);     //Numpad
+    widget_image(widgets, ASSET_CLUE);              //Hint button
+    widget_image(widgets, ASSET_ICON_SETTING);      //Customize button
+    widget_image(widgets, ASSET_EXIT);              //Exit button
+    widget_text(widgets, "Notes");
+    widget_text(widgets, "Fill");
+    widget_text(widgets, "Undo");
+    widget_text(widgets, "Redo");
+    for (int i = 0; i < 3; i++)
+        widget_image(widgets, ASSET_HEART);         //Hearts
+    widget_image(widgets, ASSET_RESULT_BOX);        //Game result frame
+    widget_image(widgets, ASSET_RESTART);           //Restart button in result box
+    widget_image(widgets, ASSET_EXIT);              //Exit button in result box
 }
 
 /**
- * @brief Funkcja zwalniająca pamięć zaalokowaną dla tablicy komórek CELL.
+ * @brief Ustawia widoczność i stan widżetów ekranu gry.
  *
- * @param ptr Wskaźnik na tablicę komórek CELL.
+ * @param widgets Widżety ekranu gry.
+ * @param count_heart Liczba pozostałych żyć.
+ * @param gameEnd Czy gra została zakończona (widoczne okno wyniku).
+ * @param notes_mode Czy włączony jest tryb notatek.
  */
-// Free memory allocated for CELL array
-void free_ptr(struct CELL* ptr) {
-    free(ptr);
-    ptr = NULL;
-}
-
-/**
- * @brief Funkcja dodająca element do tablicy komórek CELL.
- *
- * @param array Wskaźnik na wskaźnik tablicy komórek CELL.
- * @param frame Komórka do dodania.
- * @param i Indeks, pod którym ma być dodany element.
- * @param size Rozmiar tablicy.
- */
-// Add an element to the CELL array
-void add_element(struct CELL** array, struct CELL frame, int i, int* size) {
-    if (i >= *size) {
-        *size += 10;
-        bool success = allocate_array(*size, array);
-        verification(success);
-    }
-    (*array)[i] = frame;
+// Sync visibility with the game state; the hit table is rebuilt only when it changes
+void showGameWidgets(struct Widgets* widgets, int count_heart, bool gameEnd, bool notes_mode) {
+    for (int i = 0; i < 3; i++)
+        widget_set(widgets, BUTTON_HEART + i, WIDGET_VISIBLE, i < count_heart);
+    for (int id = BUTTON_RESULT; id <= BUTTON_EXIT_BOX; id++)
+        widget_set(widgets, id, WIDGET_VISIBLE, gameEnd);
+    widget_set(widgets, BUTTON_NOTES, WIDGET_ACTIVE, notes_mode);
 }
 
 /**
@@ -285,7 +147,7 @@ bool check_finish_game(int count_hearts, bool *WIN, bool *LOSE) {
         return true;
     }
 
-    if (size_array_zero <= 0) {
+    if (masks_complete(&board_masks)) {
         *WIN = true;
         return true;
     }
@@ -298,166 +160,143 @@ bool check_finish_game(int count_hearts, bool *WIN, bool *LOSE) {
  * @brief Funkcja rysująca cyfry na ekranie
  *
  * Przeszukujemy elementy macierzy sudoki i jeśli jest ona równa liczbie od 1 do 9, podświetlamy tę liczbę w siatce
+ *
+ * @param widgets Widżety ekranu gry (cyfry planszy używają tekstur klawiatury numerycznej).
+ * @param grid Plansza rysowanej klatki.
+ * @param L Układ ekranu rysowanej klatki.
  */
 //Displaying numbers on the screen 
-void matrix_validation()
+void matrix_validation(const struct Widgets* widgets, const int grid[9][9], const struct Layout* L)
 {
-    //Uploading images
-    ALLEGRO_BITMAP* num1 = al_load_bitmap("image/numbers/1.png");
-    if (!num1) exit(-3);
-    ALLEGRO_BITMAP* num2 = al_load_bitmap("image/numbers/2.png");
-    if (!num2) exit(-3);
-    ALLEGRO_BITMAP* num3 = al_load_bitmap("image/numbers/3.png");
-    if (!num3) exit(-3);
-    ALLEGRO_BITMAP* num4 = al_load_bitmap("image/numbers/4.png");
-    if (!num4) exit(-3);
-    ALLEGRO_BITMAP* num5 = al_load_bitmap("image/numbers/5.png");
-    if (!num5) exit(-3);
-    ALLEGRO_BITMAP* num6 = al_load_bitmap("image/numbers/6.png");
-    if (!num6) exit(-3);
-    ALLEGRO_BITMAP* num7 = al_load_bitmap("image/numbers/7.png");
-    if (!num7) exit(-3);
-    ALLEGRO_BITMAP* num8 = al_load_bitmap("image/numbers/8.png");
-    if (!num8) exit(-3);
-    ALLEGRO_BITMAP* num9 = al_load_bitmap("image/numbers/9.png");
-    if (!num9) exit(-3);
-
-
-    float width = 0;       //Size of digits
-    float height = 0;
-    int x = 0, y = 0;       //Coordinates
-    int k_x = 0, k_y = 0;   //Coefficient
-
-    //Sizing for different screen extensions
-    if (resolution[0][0] == W)
-    {
-        width = W / 13;
-        height = H / 13;
-        k_x = 10;
-        k_y = 7;
-    }
-    if (resolution[1][0] == W)
-    {
-        width = W / 12.5;
-        height = H / 12.5;
-        k_x = 10;
-        k_y = 5;
-    }
-    if (resolution[2][0] == W)
-    {
-        width = W / 12;
-        height = H / 12;
-        k_x = 7;
-        k_y = 3;
-    }
-
-    //Drawing of numbers
-    for (int i = 0; i < 9; i++){
-        for (int j = 0; j < 9; j++){
-            // Calculate coordinates for each cell
-            x = (j * (width + k_x)) + (W / 90);
-            y = (i * (height + k_y)) + (H / 100);
-
-            if (matrix_area[i][j] == 1)
-                al_draw_scaled_bitmap(num1, 0, 0, al_get_bitmap_width(num1), al_get_bitmap_height(num1), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 2)
-                al_draw_scaled_bitmap(num2, 0, 0, al_get_bitmap_width(num2), al_get_bitmap_height(num2), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 3)
-                al_draw_scaled_bitmap(num3, 0, 0, al_get_bitmap_width(num3), al_get_bitmap_height(num3), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 4)
-                al_draw_scaled_bitmap(num4, 0, 0, al_get_bitmap_width(num4), al_get_bitmap_height(num4), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 5)
-                al_draw_scaled_bitmap(num5, 0, 0, al_get_bitmap_width(num5), al_get_bitmap_height(num5), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 6)
-                al_draw_scaled_bitmap(num6, 0, 0, al_get_bitmap_width(num6), al_get_bitmap_height(num6), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 7)
-                al_draw_scaled_bitmap(num7, 0, 0, al_get_bitmap_width(num7), al_get_bitmap_height(num7), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 8)
-                al_draw_scaled_bitmap(num8, 0, 0, al_get_bitmap_width(num8), al_get_bitmap_height(num8), x, y, width, height, 0);
-            else if (matrix_area[i][j] == 9)
-                al_draw_scaled_bitmap(num9, 0, 0, al_get_bitmap_width(num9), al_get_bitmap_height(num9), x, y, width, height, 0);
+    //Drawing of numbers in one batch; the textures are the numpad ones
+    al_hold_bitmap_drawing(true);
+    for (int cell = 0; cell < 81; cell++) {
+        int num = grid[cell / 9][cell % 9];
+        if (num >= 1 && num <= 9) {
+            // Rectangle of the digit from the layout table
+            struct Rect r = L->digits[cell];
+            texture_draw(widgets->texture[BUTTON_NUMPAD + num - 1], r.x, r.y, r.width, r.height);
         }
     }
-    al_destroy_bitmap(num1);
-    al_destroy_bitmap(num2);
-    al_destroy_bitmap(num3);
-    al_destroy_bitmap(num4);
-    al_destroy_bitmap(num5);
-    al_destroy_bitmap(num6);
-    al_destroy_bitmap(num7);
-    al_destroy_bitmap(num8);
-    al_destroy_bitmap(num9);
+    al_hold_bitmap_drawing(false);
 }
 
 /**
- * @brief Wypełnia tablicę array_zero pustymi komórkami planszy Sudoku.
+ * @brief Zwraca komórkę planszy pod wskazanym punktem.
+ *
+ * @param x Współrzędna x.
+ * @param y Współrzędna y.
+ * @return Indeks komórki 0-80 lub -1 poza planszą.
  */
-void fillArrayZero()
+// Map a point to a board cell with one divide per axis
+int boardCellAt(float x, float y)
 {
-    float width = 0.0; // Cell width
-    float height = 0.0; // Cell height
-    float x = 0, y = 0; // Coordinates
-    int idx = 0; // Element index in array_zero
+    if (x < 0 || y < 0)
+        return -1;
+    int column = (int)(x / layout.cell_width);
+    int row = (int)(y / layout.cell_height);
+    return (row < 9 && column < 9) ? row * 9 + column : -1;
+}
 
-    // Determine the cell size depending on the screen resolution
-    if (resolution[0][0] == W)
-    {
-        width = W / 10.74;
-        height = H / 11.61;
-    }
-    if (resolution[1][0] == W)
-    {
-        width = W / 10.9756;
-        height = H / 11.53846;
-    }
-    if (resolution[2][0] == W)
-    {
-        width = W / 10.752688;
-        height = H / 11.6279;
-    }
+/**
+ * @brief Ustawia widżety ekranu gry z tabeli układu.
+ *
+ * @param widgets Widżety ekranu gry.
+ */
+// Place the game screen widgets from the layout table
+void placeGame(struct Widgets* widgets)
+{
+    for (int id = 0; id < BUTTON_COUNT; id++)
+        widget_place(widgets, id, layout.game[id]);
+}
 
-    // Draw a frame for the selected cell
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            x = j * width + (W / 90);
-            y = i * height + (H / 100);
-            if (matrix_area[i][j] == 0) {
-                // Define the coordinates and dimensions of the frame around the selected cell
-                float frame_x = j * (W / 10.9);
-                float frame_y = i * (H / 11.5);
-                float frame_width = width;
-                float frame_height = height;
-                // Draw a frame for the selected cell
-                struct CELL frame = (struct CELL){ "image/numbers/frame.png", frame_width, frame_height, frame_x, frame_y, show, i, j };
-                add_element(&array_zero, frame, idx, &size);
-                idx++;
-                size_array_zero++;
-               
-;           }
-        }
+/**
+ * @brief Losuje nową planszę wybranego poziomu z banku (bank.h).
+ *
+ * Bez pliku banku plansza jest generowana i oceniana technikami logicznymi (rater.h)
+ * w usłudze rozwiązywania, poza wątkiem logiki (game_request_board).
+ *
+ * @param solution Tablica na rozwiązanie planszy zapisane w banku.
+ * @return false, jeśli bank nie ma plansz wybranego poziomu.
+ */
+//Function for picking a new board of the chosen difficulty
+bool newBoard(int solution[9][9]) {
+    return bank_pick(&puzzle_bank, difficult_level(difficult), matrix_area, solution);
+}
+
+/**
+ * @brief Stosuje grupę rekordów dziennika do planszy, masek, notatek i zbioru pustych komórek.
+ *
+ * @param entries Rekordy jednej akcji.
+ * @param n Liczba rekordów.
+ * @param undo true – przywraca stare wartości, false – ponawia nowe.
+ * @param notes Notatki komórek.
+ * @param count_clue Liczba dostępnych wskazówek.
+ */
+//Apply one journal action; undo restores the old values
+void applyJournal(const struct JournalEntry* entries, int n, bool undo, struct Notes* notes, int* count_clue) {
+    for (int i = 0; i < n; i++) {
+        int cell = entries[i].cell;
+        int row = cell / 9, column = cell % 9;
+        int old_value = entries[i].values >> 4, new_value = entries[i].values & 0xF;
+        int from = undo ? new_value : old_value;
+        int to = undo ? old_value : new_value;
+        notes->mask[cell] ^= entries[i].notes;
+        *count_clue += undo ? -entries[i].clues : entries[i].clues;
+        if (from == to)
+            continue;
+        if (from)
+            masks_clear(&board_masks, row, column, from);
+        if (to)
+            masks_set(&board_masks, row, column, to);
+        matrix_area[row][column] = to;
+        if (to == 0)
+            cellset_insert(&empty_cells, cell);
+        else
+            cellset_remove(&empty_cells, cell);
     }
 }
 
 /**
  * @brief Zapisuje stan gry.
  *
+ * @param slot Numer slotu zapisu.
  * @param count_clue Liczba dostępnych wskazówek.
  * @param count_heart Liczba dostępnych żyć.
- * @param minutes Liczba minut na zegarze gry.
- * @param seconds Liczba sekund na zegarze gry.
- * @param time_count Całkowity czas gry.
+ * @param time_ms Czas gry w milisekundach.
+ * @param notes Notatki komórek.
+ * @param journal Dziennik cofania i ponawiania.
+ * @param board Zaimportowana plansza (dla restartu po kontynuacji) lub NULL.
  */
 //Function for saving the game
-void saveGame(int count_clue, int count_heart, unsigned int minutes, unsigned int seconds, unsigned int time_count){
+void saveGame(int slot, int count_clue, int count_heart, unsigned int time_ms, const struct Notes* notes, const struct Journal* journal, const int (*board)[9]){
     struct GameState gameState;
     memcpy(gameState.matrix_area, matrix_area, sizeof(matrix_area));
     gameState.hints = count_clue;
     gameState.hearts = count_heart;
-    gameState.minutes = minutes;
-    gameState.seconds = seconds;
-    gameState.time_count = time_count;
-
-    if (save_game(&gameState)) {
+    gameState.time_ms = time_ms;
+
+    // Metadata for the slot list in the menu
+    struct SlotInfo info = { 0 };
+    info.difficult[0] = difficult[0];
+    info.difficult[1] = difficult[1];
+    info.time_ms = time_ms;
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++)
+            if (matrix_area[i][j] != 0)
+                info.filled++;
+
+    // Notes and undo history
+    struct SaveExtra extra;
+    memcpy(extra.notes, notes->mask, sizeof(extra.notes));
+    extra.journal = *journal;
+    extra.has_board = board != NULL;
+    if (board != NULL)
+        memcpy(extra.board, board, sizeof(extra.board));
+    else
+        memset(extra.board, 0, sizeof(extra.board));
+
+    if (save_game(slot, &gameState, info, &extra)) {
         fprintf(stderr, "Game saved successfully.\n");
     }
     else {
@@ -466,413 +305,714 @@ void saveGame(int count_clue, int count_heart, unsigned int minutes, unsigned in
 }
 
 /**
- * @brief Funkcja obsługująca proces gry, czyli Sudoku.
- * Posiada pętlę gry, rysuje tło, przyciski, scenę gry, numpad, sprawdza zdarzenia takie jak: 
- * zamknięcie okna oraz naciśnięcie przycisku. Jeśli ustawienia zostaną
- * zaakceptowane, zmiana rozmiaru okna oraz aktualizowanie pozycji i rozmiarów przycisków.
+ * @struct GameScene
+ * @brief Stan sceny gry; widżety i atlas notatek pozostają między grami.
+ */
+struct GameScene {
+    struct Widgets widgets;             ///< Widżety w kolejności enum GameButton.
+    int background;                     ///< Uchwyt tekstury tła.
+    int frame_texture;                  ///< Uchwyt tekstury ramki zaznaczonej komórki.
+
+    int slot;                           ///< Slot zapisu gry.
+    bool has_board;                     ///< Czy gra toczy się na zaimportowanej planszy.
+    int board[9][9];                    ///< Zaimportowana plansza (dla restartu).
+
+    int count_clue;                     ///< Liczba dostępnych wskazówek.
+    struct HintEngine hints;            ///< Silnik podpowiedzi.
+    bool conflict_cells[81];            ///< Komórki kolidujące z ostatnią odrzuconą cyfrą.
+    double conflict_until;              ///< Koniec podświetlenia kolizji (al_get_time).
+    const char* hint_text;              ///< Technika ostatniej podpowiedzi lub komunikat usługi rozwiązywania.
+    int count_heart;                    ///< Liczba pozostałych żyć.
+
+    struct Notes notes;                 ///< Notatki i atlas małych cyfr.
+    bool notes_mode;                    ///< Klawiatura przełącza notatki zamiast wpisywać cyfry.
+    struct Journal journal;             ///< Dziennik cofania i ponawiania.
+
+    int selected;                       ///< Zaznaczona pusta komórka (0-80).
+    bool show_frame;                    ///< Czy wyświetlać ramkę.
+
+    bool gameEnd;                       ///< Koniec gry.
+    bool gameWIN;                       ///< Wygrana.
+    bool gameLOSE;                      ///< Przegrana.
+    bool resultSaved;                   ///< Czy wynik tej gry został zapisany w statystykach.
+
+    struct Stopwatch clock;             ///< Zegar gry.
+
+    unsigned int generation;            ///< Generacja planszy w usłudze rozwiązywania.
+    int pending_move;                   ///< Komórka ruchu czekającego na sprawdzenie lub -1.
+    int pending_digit;                  ///< Cyfra ruchu czekającego na sprawdzenie.
+    int pending_check;                  ///< Żądanie sprawdzenia ruchu (0 – brak).
+    int pending_hint;                   ///< Żądanie podpowiedzi (0 – brak).
+    int pending_solution;               ///< Żądanie rozwiązania planszy (0 – brak).
+    int pending_board;                  ///< Żądanie wygenerowania planszy (0 – brak).
+};
+
+/**
+ * @brief Scena gry.
+ */
+struct GameScene game_scene;
 
- * @param display Wskaźnik na ekran Allegro.
- * @param event_queue Kolejka zdarzeń Allegro.
- * @param contGame Flaga kontynuacji gry.
- * @return Wartość logiczna określająca, czy gra została zakończona.
+/**
+ * @brief Sprawdza wynik gry, zapisuje go w statystykach i dopasowuje widżety do stanu gry.
  */
-//Game process (Sudoku itself) parameters (screen, events)
-bool game(ALLEGRO_DISPLAY* display, ALLEGRO_EVENT_QUEUE* event_queue, bool contGame)
+//Bring the result and the widgets up to date, so the next snapshot is complete
+void game_update(void)
 {
-    // Variable to store events
-    ALLEGRO_EVENT event;            
-
-    // Load font
-    int fontSize = 0;
-    if (W == resolution[0][0])
-        fontSize = 25;
-    else if (W == resolution[1][0])
-        fontSize = 30;
-    else if (W == resolution[2][0])
-        fontSize = 34;
-
-    ALLEGRO_FONT* font = al_load_ttf_font("Tenada.ttf", fontSize, 0);
-    if (!font) exit(-2);
-
-    // Load background
-    ALLEGRO_BITMAP* background = al_load_bitmap("image/background.png");
-    if (!background) exit(-3);
-
-    //Load game result frame
-    ALLEGRO_BITMAP* box_result = al_load_bitmap("image/result_box.png");
-
-    // Create an ALLEGRO_TIMER object with the desired frame rate
-    ALLEGRO_TIMER* timer = al_create_timer(1.0 / FPS);
-
-    //Create a game timer
-    ALLEGRO_TIMER* timeGame = al_create_timer(1);
-
-    // Register the timer's event source with the event queue
-    // This allows the event queue to receive timer-related events
-    al_register_event_source(event_queue, al_get_timer_event_source(timer));    
-    al_register_event_source(event_queue, al_get_timer_event_source(timeGame)); //for the stopwatch
-
-    //Creating a hint button
-    struct OBJECT clue = (struct OBJECT){ "image/clue.png", W / 8, H / 8, 0,0, show };
-    clue.x = W - clue.width - 10;
-    clue.y = H - clue.height - 25;
-
-    //Creating a customize button
-    struct OBJECT b_setting = (struct OBJECT){ "image/icon_setting.png", W / 20, H / 20, 0, 0, show };
-    b_setting.x = W - b_setting.width - 5;
-    b_setting.y = 5;
-
-    //Creating an exit button
-    struct OBJECT b_exit = (struct OBJECT){ "image/exit.png", W / 20, H / 20, 0, 0, show };
-    b_exit.x = b_setting.x - b_exit.width - 20;
-    b_exit.y = b_setting.y;
-
-    //Creating an exit button in result box
-    struct OBJECT b_exitBox = (struct OBJECT){ "image/exit.png", W / 18, H / 18, 0, 0, show };
-    b_exitBox.x = 3 * W / 4.55;
-    b_exitBox.y = H / 2.1;
-
-    //Creating an restart button in result box
-    struct OBJECT b_restart = (struct OBJECT){ "image/restart.png", W / 12, H / 12, 0, 0, show };
-    b_restart.x = W / 3.5;
-    b_restart.y = H / 2.15;
-
-    const int total_clue = 3;           //Total hints (static value)
-    int count_clue = total_clue;        //Number of hints
-    char count_clue_str[10];            //For conversion from int to char (string)
+    struct GameScene* G = &game_scene;
+    G->gameEnd = check_finish_game(G->count_heart, &G->gameWIN, &G->gameLOSE);  //Checking the result of the game
+    //The clock waits while the board is being generated
+    if (G->pending_board)
+        stopwatch_hold(&G->clock, HOLD_BOARD);
+    else
+        stopwatch_release(&G->clock, HOLD_BOARD);
+    if (G->gameEnd) {
+        stopwatch_hold(&G->clock, HOLD_END);
+        G->pending_move = -1;               //Requests still on their way are ignored once the game is over
+        G->pending_hint = 0;
+    }
+    if (G->gameEnd && !G->resultSaved) {
+        //Record the result of the game in the stats
+        struct GameResult result = { stopwatch_ms(&G->clock) / 1000, difficult_level(difficult), G->count_heart, TOTAL_CLUE - G->count_clue, G->gameWIN };
+        record_result(result);
+        G->resultSaved = true;
+    }
+    showGameWidgets(&G->widgets, G->count_heart, G->gameEnd, G->notes_mode);  //Hearts, result box and notes toggle follow the state
+}
 
+/**
+ * @brief Unieważnia wszystkie żądania gry do usługi rozwiązywania.
+ *
+ * @param G Stan gry.
+ */
+//Results for the previous board are stale
+static void game_drop_requests(struct GameScene* G)
+{
+    G->generation = solve_board_changed();
+    G->pending_move = -1;
+    G->pending_check = 0;
+    G->pending_hint = 0;
+    G->pending_solution = 0;
+    G->pending_board = 0;
+}
 
-    int count_heart = 3;                //All hearts
-    int heart_width = W / 9;            //The size of the hearts
-    int heart_height = H / 9;
+/**
+ * @brief Przekazuje ruch do sprawdzenia usłudze rozwiązywania; komórka czeka na wynik.
+ *
+ * @param G Stan gry.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param num Cyfra.
+ */
+//A newer move replaces the one still being checked
+static void game_check_move(struct GameScene* G, int row, int column, int num)
+{
+    if (G->pending_check)
+        solve_cancel(G->pending_check);
+    struct SolveRequest request;
+    solve_request(&request, SOLVE_VALIDATE, matrix_area);
+    request.row = row;
+    request.column = column;
+    request.digit = num;
+    G->pending_check = solve_submit(&request);
+    G->pending_move = G->pending_check ? row * 9 + column : -1;
+    G->pending_digit = num;
+    G->hint_text = G->pending_check ? NULL : "Solver busy";
+}
 
-    //Hearts
-    struct OBJECT hearts[3];
-    for (int i = 0; i < count_heart; i++)
-    {
-        hearts[i] = (struct OBJECT){ "image/heart.png", heart_width, heart_height, W - heart_width - 20, 70 + (i * heart_height + 25), show };  //Сердца в массив закидываем
+/**
+ * @brief Unieważnia żądania do usługi rozwiązywania po zmianie planszy.
+ *
+ * Jeśli rozwiązanie planszy nie jest jeszcze znane, wysyła żądanie jego wyznaczenia.
+ * Ruch czekający na sprawdzenie jest sprawdzany ponownie na nowej planszy, a jeśli
+ * jego komórka została w międzyczasie wypełniona – odrzucany z komunikatem.
+ *
+ * @param G Stan gry.
+ */
+//The solution is requested again until it is known
+static void game_board_changed(struct GameScene* G)
+{
+    int move = G->pending_move, digit = G->pending_digit;
+    game_drop_requests(G);
+    if (!hint_solved(&G->hints)) {
+        struct SolveRequest request;
+        solve_request(&request, SOLVE_COUNT, matrix_area);
+        G->pending_solution = solve_submit(&request);
+    }
+    if (move >= 0 && matrix_area[move / 9][move % 9] == 0)
+        game_check_move(G, move / 9, move % 9, digit);
+    else if (move >= 0)
+        G->hint_text = "Move cancelled";
+}
+
+/**
+ * @brief Przygotowuje maski, puste komórki i silnik podpowiedzi dla nowej planszy w matrix_area.
+ *
+ * @param G Stan gry.
+ * @param solution Znane rozwiązanie planszy (z banku) lub NULL – wtedy wyznacza je usługa rozwiązywania.
+ */
+static void game_setup_board(struct GameScene* G, const int (*solution)[9])
+{
+    game_drop_requests(G);                      //A move still being checked belongs to the previous board
+    cellset_init(&empty_cells, matrix_area);
+    masks_init(&board_masks, matrix_area);
+    hint_start(&G->hints, matrix_area);
+    if (solution != NULL)
+        hint_set_solution(&G->hints, solution);
+    game_board_changed(G);
+}
+
+/**
+ * @brief Zleca wygenerowanie planszy wybranego poziomu usłudze rozwiązywania.
+ *
+ * Do nadejścia wyniku plansza jest pusta, zegar stoi, a działają tylko przyciski
+ * ustawień i wyjścia.
+ *
+ * @param G Stan gry.
+ */
+//No bank puzzle for the level: the board is generated off the logic thread
+static void game_request_board(struct GameScene* G)
+{
+    static unsigned int seed = 0;
+    if (seed == 0)
+        seed = (unsigned int)time(NULL) | 1;
+    memset(matrix_area, 0, sizeof(matrix_area));
+    cellset_init(&empty_cells, matrix_area);
+    masks_init(&board_masks, matrix_area);
+    hint_start(&G->hints, matrix_area);
+    game_drop_requests(G);
+
+    struct SolveRequest request;
+    solve_request(&request, SOLVE_GENERATE, matrix_area);
+    request.level = difficult_level(difficult);
+    request.seed = seed;
+    seed = seed * 1664525u + 1013904223u;       //Next board gets a different seed
+    G->pending_board = solve_submit(&request);
+    if (!G->pending_board) {
+        //The service is not running: generate here, capped like the service
+        generate_puzzle(request.level, matrix_area, &request.seed, SOLVE_GENERATE_ATTEMPTS, NULL);
+        game_setup_board(G, NULL);
     }
+}
+
+/**
+ * @brief Wpisuje sprawdzoną cyfrę: poprawna wypełnia komórkę, błędna zabiera życie.
+ *
+ * @param G Stan gry.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param num Cyfra.
+ * @param correct Czy cyfra jest poprawna.
+ */
+static void game_move(struct GameScene* G, int row, int column, int num, bool correct)
+{
+    if (correct) {
+        matrix_area[row][column] = num;
+        masks_set(&board_masks, row, column, num);
+        notes_prune(&G->notes, row, column, num);
+        cellset_remove(&empty_cells, row * 9 + column);  //The cell is no longer empty
+        if (G->selected == row * 9 + column)
+            G->show_frame = false;
+        hint_place(&G->hints, row, column, num);
+        G->hint_text = NULL;
+        game_board_changed(G);
+    }
+    else {
+        G->count_heart--;
+    }
+}
 
-    // Generate numpad buttons
-    generation_numpad();
+/**
+ * @brief Wpisuje podpowiedź i zużywa wskazówkę.
+ *
+ * @param G Stan gry.
+ * @param hint Podpowiedź (już uwzględniona w silniku podpowiedzi).
+ */
+static void game_place_hint(struct GameScene* G, const struct Hint* hint)
+{
+    matrix_area[hint->row][hint->column] = hint->digit;
+    masks_set(&board_masks, hint->row, hint->column, hint->digit);
+    notes_prune(&G->notes, hint->row, hint->column, hint->digit);
+    cellset_remove(&empty_cells, hint->row * 9 + hint->column);
+    if (G->selected == hint->row * 9 + hint->column)
+        G->show_frame = false;
+    G->count_clue--;
+    G->hint_text = logic_names[hint->technique];
+    game_board_changed(G);
+}
 
-    int idx = 0;                    //Index of the selected empty cell
-    bool show_frame = false;        //Whether to display a frame
-    bool change_set = false;        //Change window extension
+/**
+ * @brief Obsługuje wynik usługi rozwiązywania (zdarzenie SOLVE_EVENT).
+ *
+ * Wyniki dla poprzedniej planszy albo żądań, na które gra już nie czeka, są pomijane.
+ *
+ * @param result Wynik.
+ */
+//Results arrive through the event queue; the board may have changed since the request
+void game_solved(const struct SolveResult* result)
+{
+    struct GameScene* G = &game_scene;
+    if (result->generation != G->generation || G->gameEnd)
+        return;
+
+    //The generated board starts the game; it is not an undoable step
+    if (result->kind == SOLVE_GENERATE) {
+        if (result->id != G->pending_board)
+            return;
+        memcpy(matrix_area, result->solution, sizeof(matrix_area));
+        game_setup_board(G, NULL);
+        game_update();
+        return;
+    }
+
+    int clue_before = G->count_clue;
+    int grid_before[9][9];
+    unsigned short notes_before[81];
+    memcpy(grid_before, matrix_area, sizeof(grid_before));
+    memcpy(notes_before, G->notes.mask, sizeof(notes_before));
+
+    switch (result->kind) {
+    case SOLVE_COUNT:
+        if (result->id != G->pending_solution)
+            return;
+        G->pending_solution = 0;
+        if (result->status == SOLVE_DONE && result->count == 1)
+            hint_set_solution(&G->hints, result->solution);
+        break;
+    case SOLVE_VALIDATE:
+        if (result->id != G->pending_check)
+            return;
+        G->pending_check = 0;
+        G->pending_move = -1;
+        if (result->status == SOLVE_DONE)
+            game_move(G, result->row, result->column, result->digit, result->count > 0);
+        else
+            G->hint_text = "Too hard to check";     //Over budget: the move is dropped and no heart is lost
+        break;
+    case SOLVE_GENERATE:
+        break;
+    case SOLVE_HINT:
+        if (result->id != G->pending_hint)
+            return;
+        G->pending_hint = 0;
+        if (result->status == SOLVE_DONE && result->count > 0) {
+            struct Hint hint = { result->row, result->column, result->digit, LOGIC_GUESS };
+            hint_place(&G->hints, hint.row, hint.column, hint.digit);
+            game_place_hint(G, &hint);
+        }
+        else {
+            G->hint_text = "No hint found";
+        }
+        break;
+    }
 
-    bool gameEnd = false;       //End-of-game flag
-    bool gameWIN = false;       //Victory flag
-    bool gameLOSE = false;      //Lose flag
+    //A move or hint that arrived later is one undo step like a click
+    journal_record(&G->journal, grid_before, matrix_area, notes_before, G->notes.mask, G->count_clue - clue_before);
+    game_update();
+}
 
-    char timeResult[50];            //Stopwatch Text
-    unsigned int time_count = 0;    //Time
-    unsigned int minutes=0;
-    unsigned int seconds=0;
+/**
+ * @brief Rozpoczyna grę (scenę gry): wczytuje zapis, importowaną planszę lub losuje nową.
+ *
+ * @param contGame Flaga kontynuacji gry.
+ * @param slot Numer slotu zapisu, z którego gra jest wczytywana i do którego jest zapisywana.
+ * @param board Zaimportowana plansza do rozegrania lub NULL, jeśli plansza ma zostać wygenerowana.
+ * @return false, jeśli zapisu nie udało się wczytać (scena gry nie jest wtedy otwierana).
+ */
+//Start the game scene; textures and fonts belong to the render thread
+bool game_enter(bool contGame, int slot, const int (*board)[9])
+{
+    struct GameScene* G = &game_scene;
+
+    //Buttons, hearts and result box are created once; positions and sizes come from the layout table
+    if (G->widgets.count == 0) {
+        createGameWidgets(&G->widgets);
+        G->background = texture_handle(ASSET_BACKGROUND);
+        G->frame_texture = texture_handle(ASSET_NUMBERS_FRAME);
+    }
+    placeGame(&G->widgets);
+
+    G->slot = slot;
+    G->has_board = board != NULL;
+    if (board != NULL)
+        memcpy(G->board, board, sizeof(G->board));
+
+    G->count_clue = TOTAL_CLUE;
+    G->conflict_until = 0;
+    G->hint_text = NULL;
+    G->count_heart = TOTAL_HEARTS;
+    notes_clear(&G->notes);
+    G->notes_mode = false;
+    journal_clear(&G->journal);
+    G->selected = 0;
+    G->show_frame = false;
+    G->gameEnd = false;
+    G->gameWIN = false;
+    G->gameLOSE = false;
+    G->resultSaved = false;
+    unsigned int time_ms = 0;
 
     //If the continue button in the menu has been pressed
     if (contGame) {
         // Using the download function
         struct GameState loadedGameState;
-        if (load_game(&loadedGameState)) {
+        struct SaveExtra extra;
+        if (load_game(slot, &loadedGameState, &extra)) {
             fprintf(stderr, "Game loaded successfully.\n");
             // Use loadedGameState to restore the game state
         }
         else {
+            //A missing or corrupt save is not played; the menu stays open
             fprintf(stderr, "Failed to load the game.\n");
+            return false;
         }
 
         memcpy(matrix_area, loadedGameState.matrix_area, sizeof(matrix_area));
-        count_clue = loadedGameState.hints;
-        count_heart = loadedGameState.hearts;
-        minutes = loadedGameState.minutes;
-        seconds = loadedGameState.seconds;
-        time_count = loadedGameState.time_count;
+        G->count_clue = loadedGameState.hints;
+        G->count_heart = loadedGameState.hearts;
+        time_ms = loadedGameState.time_ms;
+        memcpy(G->notes.mask, extra.notes, sizeof(G->notes.mask));
+        G->journal = extra.journal;
+        //The givens of an imported puzzle, so that a restart replays it
+        G->has_board = extra.has_board != 0;
+        if (G->has_board)
+            memcpy(G->board, extra.board, sizeof(G->board));
+
+        // Restore the difficulty of the slot so that a restart keeps it
+        struct SaveIndex index;
+        load_index(&index);
+        if (index.slots[slot].used) {
+            difficult[0] = index.slots[slot].difficult[0];
+            difficult[1] = index.slots[slot].difficult[1];
+        }
     }
 
-    if (!contGame) {
-        sudmatrix(matrix_area, difficult);
-    }
-    array_zero = (struct CELL*)malloc(size * sizeof(struct CELL));
-    size_array_zero = 0;
-    fillArrayZero();
-
-    bool finish = false;
-    al_start_timer(timer);
-    al_start_timer(timeGame);
-    while (!finish)
-    {
-        
-        al_wait_for_event(event_queue, &event);
-        gameEnd = check_finish_game(count_heart, &gameWIN, &gameLOSE);  //Checking the result of the game
-        check_song_finished();                                          //Check that the background music is over
+    if (!contGame && board != NULL)
+        memcpy(matrix_area, board, sizeof(matrix_area));   //Imported puzzle
+    //A bank board comes with its solution, so no solve is queued for it
+    int solution[9][9];
+    bool banked = !contGame && board == NULL && newBoard(solution);
+    if (contGame || board != NULL || banked)
+        game_setup_board(G, banked ? solution : NULL);
+    else
+        game_request_board(G);
 
-        if (event.type == ALLEGRO_EVENT_DISPLAY_CLOSE)                  //Check if the window is closed
-        {
-            finish = true;
-        }
+    //A continued game that had already ended has its result recorded
+    if (contGame)
+        G->resultSaved = check_finish_game(G->count_heart, &G->gameWIN, &G->gameLOSE);
+
+    stopwatch_reset(&G->clock, time_ms);
+    game_update();
+    scene_push(SCENE_GAME);
+    return true;
+}
+
+/**
+ * @brief Kończy grę i wraca do sceny pod nią.
+ *
+ * @param save true – stan gry jest zapisywany, false – slot jest usuwany (gra zakończona).
+ */
+//Leave the game scene; resident assets stay loaded
+void game_leave(bool save)
+{
+    struct GameScene* G = &game_scene;
+    //A game whose board is still being generated has nothing to save
+    if (save && !G->pending_board)
+        saveGame(G->slot, G->count_clue, G->count_heart, stopwatch_ms(&G->clock), &G->notes, &G->journal, G->has_board ? G->board : NULL);
+    else
+        delete_slot(G->slot);
+    game_drop_requests(G);                      //Results still on their way belong to this game
+    scene_pop();
+}
+
+/**
+ * @brief Wznawia zegar gry i dopasowuje scenę gry do układu po zamknięciu ustawień.
+ *
+ * @param accepted Czy ustawienia zostały zaakceptowane (zmiana rozmiaru okna).
+ */
+//If the settings are accepted, adjust everything to fit the window size
+void game_resume(bool accepted)
+{
+    stopwatch_release(&game_scene.clock, HOLD_SETTING);
+    if (!accepted)
+        return;
+    placeGame(&game_scene.widgets);
+}
+
+/**
+ * @brief Wstrzymuje lub wznawia zegar gry przy utracie i odzyskaniu fokusu okna.
+ *
+ * @param focused Czy okno ma fokus.
+ */
+//The clock does not run while the window is in the background
+void game_focus(bool focused)
+{
+    if (focused)
+        stopwatch_release(&game_scene.clock, HOLD_FOCUS);
+    else
+        stopwatch_hold(&game_scene.clock, HOLD_FOCUS);
+}
 
-        if (event.type == ALLEGRO_EVENT_MOUSE_BUTTON_DOWN)              //Check for mouse button release
+/**
+ * @brief Obsługuje kliknięcia w grze: przyciski, komórki i okno wyniku.
+ *
+ * @param event Zdarzenie.
+ */
+//Game process (Sudoku itself): one event of the main loop
+static void game_input(const ALLEGRO_EVENT* event)
+{
+    struct GameScene* G = &game_scene;
+    struct JournalEntry journal_group[JOURNAL_GROUP_MAX];
+    int grid_before[9][9];                  //Board before the current click, for the journal
+    unsigned short notes_before[81];        //Notes before the current click
+
+    if (event->type == ALLEGRO_EVENT_MOUSE_BUTTON_DOWN)              //Check for mouse button release
+    {
+        if (event->mouse.button & 1)                                  // pressing the LBM (1 - LBM, 2 - RBM, 3 - Wheel)
         {
-            if (event.mouse.button & 1)                                  // pressing the LBM (1 - LBM, 2 - RBM, 3 - Wheel)
-            {
-                int x = event.mouse.x;                              //Get mouse coordinate
-                int y = event.mouse.y;
+            int x = event->mouse.x;                             //Get mouse coordinate
+            int y = event->mouse.y;
+
+            //Checking that the game isn't over yet
+            if (G->gameEnd == false) {
+                int clue_before = G->count_clue;
+                memcpy(grid_before, matrix_area, sizeof(grid_before));
+                memcpy(notes_before, G->notes.mask, sizeof(notes_before));
+
+                int hit = widgets_hit(&G->widgets, x, y);   //Widget under the mouse
+                int cell = boardCellAt(x, y);               //Board cell under the mouse
+
+                //The board is still being generated: only the settings and exit buttons work
+                if (G->pending_board && hit != BUTTON_SETTING && hit != BUTTON_EXIT)
+                    return;
+
+                //Press the undo or redo button
+                bool undo = hit == BUTTON_UNDO;
+                int n = undo ? journal_undo(&G->journal, journal_group) : hit == BUTTON_REDO ? journal_redo(&G->journal, journal_group) : 0;
+                if (n > 0) {
+                    applyJournal(journal_group, n, undo, &G->notes, &G->count_clue);
+                    hint_reset(&G->hints, matrix_area);     //Same puzzle, so the known solution stays
+                    G->hint_text = NULL;
+                    game_board_changed(G);
+                    G->show_frame = false;
+                    clue_before = G->count_clue;
+                    memcpy(grid_before, matrix_area, sizeof(grid_before));
+                    memcpy(notes_before, G->notes.mask, sizeof(notes_before));
+                }
 
-                //Checking that the game isn't over yet
-                if (gameEnd == false) {
-                    //Press the tooltip button
-                    if (count_clue > 0 && count_clue <= 3)
+                //Press the tooltip button
+                if (G->count_clue > 0 && G->count_clue <= 3)
+                {
+                    if (hit == BUTTON_CLUE && !G->pending_hint)
                     {
-                        if (x >= clue.x && x < (clue.x + clue.width) && y >= clue.y && y < (clue.y + clue.height))    //Check if the mouse coordinates coincide with the button (if the button is pressed).
-                        {
-                            int idx_clue = rand() % size_array_zero;
-                            int row = array_zero[idx_clue].rows;
-                            int column = array_zero[idx_clue].column;
-
-                            checkSudokuHints(matrix_area, row, column);
-                            remove_element(&array_zero, size_array_zero, idx_clue);
-                            size_array_zero -= 1;
-                            count_clue--;
+                        //The easiest logical next step; no search runs here
+                        struct Hint hint;
+                        if (hint_next(&G->hints, &hint)) {
+                            game_place_hint(G, &hint);
+                        }
+                        else if (hint.row >= 0) {
+                            //Logic is not enough and the solution is not known yet: the solver service finds the digit
+                            struct SolveRequest request;
+                            solve_request(&request, SOLVE_HINT, matrix_area);
+                            request.row = hint.row;
+                            request.column = hint.column;
+                            G->pending_hint = solve_submit(&request);
+                            G->hint_text = G->pending_hint ? NULL : "Solver busy";
                         }
                     }
+                }
 
-                    //Press the settings button
-                    if (x >= b_setting.x && x < (b_setting.x + b_setting.width) && y >= b_setting.y && y < (b_setting.y + b_setting.height))
-                    {
-                        change_set = setting(display, event_queue, timer, &finish);
-                    }
+                //Press the settings button; the settings open as an overlay scene
+                if (hit == BUTTON_SETTING)
+                {
+                    stopwatch_hold(&G->clock, HOLD_SETTING);
+                    setting_enter();
+                }
 
-                    //Press the exit button
-                    if (x >= b_exit.x && x < (b_exit.x + b_exit.width) && y >= b_exit.y && y < (b_exit.y + b_exit.height))
-                    {
-                        saveGame(count_clue, count_heart, minutes, seconds, time_count);
-                        if (array_zero != NULL) {
-                            free_ptr(array_zero);
-                        }
-                        al_stop_timer(timer);
-                        al_stop_timer(timeGame);
-                        al_destroy_timer(timer);
-                        al_destroy_timer(timeGame);
-                        al_destroy_font(font);
-                        al_destroy_bitmap(box_result);
-                        al_destroy_bitmap(background);
-                        return false;
-                    }
+                //Press the exit button
+                if (hit == BUTTON_EXIT)
+                {
+                    game_leave(true);
+                    return;
+                }
 
-                    //Add a number to an empty cell
-                    for (int i = 0; i < 9; i++)
-                    {
-                        if (x >= numpad[i].x && x < (numpad[i].x + numpad[i].width) && y >= numpad[i].y && y < (numpad[i].y + numpad[i].height))
-                        {
-                            if (show_frame)
-                            {
-                                //Get the indices of the empty cell in the matrix_area
-                                int row = array_zero[idx].rows;
-                                int column = array_zero[idx].column;
-                                int num = numpad[i].num;        //Number pressed on numpad
-                                matrix_area[row][column] = num;
-                                if (checkSudoku(matrix_area, row, column)) {
-                                    remove_element(&array_zero, size_array_zero, idx); //Delete empty cell from array_zero
-                                    size_array_zero -= 1;
-                                }
-                                else {
-                                    count_heart--;
-                                    matrix_area[row][column] = 0;
-                                }
-
-                                show_frame = false;
-                            }
-                        }
-                    }
+                //Press the notes mode button
+                if (hit == BUTTON_NOTES)
+                {
+                    G->notes_mode = !G->notes_mode;
+                }
 
-                    //Check if an empty cell has been selected
-                    for (int i = 0; i < size_array_zero; i++)
-                    {
-                        if (x >= array_zero[i].x && x < (array_zero[i].x + array_zero[i].width) && y >= array_zero[i].y && y < (array_zero[i].y + array_zero[i].height))
-                        {
-                            idx = i;
-                            show_frame = true;
-                        }
-                    }
+                //Press the fill all notes button
+                if (hit == BUTTON_FILL)
+                {
+                    notes_fill(&G->notes, matrix_area, &board_masks);
                 }
-                else
+
+                //Add a number to an empty cell
+                if (hit >= BUTTON_NUMPAD && hit < BUTTON_NUMPAD + 9)
                 {
-                    //Check if the restart button is pressed
-                    if (x >= b_restart.x && x < (b_restart.x + b_restart.width) && y >= b_restart.y && y < (b_restart.y + b_restart.height))
+                    int i = hit - BUTTON_NUMPAD;
+                    if (G->show_frame && G->notes_mode)
                     {
-                        //Resetting everything
-                        count_clue = 3;
-                        count_heart = 3;
-                        for (int i = 0; i < count_heart; i++)
-                        {
-                            hearts[i] = (struct OBJECT){ "image/heart.png", heart_width, heart_height, W - heart_width - 20, 70 + (i * heart_height + 25), show };
-                        }
-                        idx = 0;
-                        size_array_zero = 0;
-                        sudmatrix(matrix_area, difficult);
-                        if (array_zero != NULL) {
-                            free_ptr(array_zero);
-                        }
-                        array_zero = (struct CELL*)malloc(size * sizeof(struct CELL));
-                        fillArrayZero();
-                        gameEnd = false;
-                        gameWIN = false;
-                        gameLOSE = false;
+                        //Toggle a note; the cell stays selected
+                        notes_toggle(&G->notes, G->selected / 9, G->selected % 9, i + 1);
                     }
-
-                    //Press the exit button
-                    if (x >= b_exitBox.x && x < (b_exitBox.x + b_exitBox.width) && y >= b_exitBox.y && y < (b_exitBox.y + b_exitBox.height))
+                    else if (G->show_frame)
                     {
-                        if (array_zero != NULL) {
-                            free_ptr(array_zero);
+                        //Get the indices of the empty cell in the matrix_area
+                        int row = G->selected / 9;
+                        int column = G->selected % 9;
+                        int num = i + 1;                //Number pressed on numpad
+                        int solution = hint_solution(&G->hints, row, column);
+                        if (masks_conflict(&board_masks, row, column, num)) {
+                            //The digit clashes with a peer - highlight the clash
+                            masks_conflict_cells(&board_masks, matrix_area, row, column, num, G->conflict_cells);
+                            G->conflict_cells[row * 9 + column] = true;
+                            G->conflict_until = al_get_time() + 1.0;
+                            game_move(G, row, column, num, false);
+                        }
+                        else if (solution != 0) {
+                            game_move(G, row, column, num, solution == num);
+                        }
+                        else {
+                            //The solution is not known yet: the solver service checks the move and the cell shows it as pending
+                            game_check_move(G, row, column, num);
                         }
-                        al_stop_timer(timer);
-                        al_stop_timer(timeGame);
-                        al_destroy_timer(timer);
-                        al_destroy_timer(timeGame);
-                        al_destroy_font(font);
-                        al_destroy_bitmap(box_result);
-                        al_destroy_bitmap(background);
-                        if(remove("save.dat") == 0)
-                            fprintf(stderr, "Deleted successfully");
-                        else
-                            fprintf(stderr, "Unable to delete the file");
-
-                        return false;
-                    }
-                } 
-            }
-        }
 
-        if (event.type == ALLEGRO_EVENT_TIMER)
-        {
-            if (event.timer.source == timer) {
-                sprintf(count_clue_str, "%d/%d", count_clue, total_clue);          //Convert from int to char (string)                                                              
-                al_draw_scaled_bitmap(background, 0, 0, al_get_bitmap_width(background), al_get_bitmap_height(background), 0, 0, W, H, 0);      //Draw background
-                al_draw_text(font, al_map_rgb(0, 0, 0), clue.x + 20, clue.y - 50, 0, count_clue_str);                                           //Draw text (number of prompts)
-                clue.show(clue.name_file, clue.width, clue.height, clue.x, clue.y);                                                             //Show tooltip button
-                b_setting.show(b_setting.name_file, b_setting.width, b_setting.height, b_setting.x, b_setting.y);                               //Display the settings button
-                b_exit.show(b_exit.name_file, b_exit.width, b_exit.height, b_exit.x, b_exit.y);                                                 //Show exit button
-                //Show exit button in result box
-
-                //Drawing of stopwatch
-                sprintf(timeResult, "%02d:%02d", minutes, seconds);
-                al_draw_text(font, al_map_rgb(0, 0, 0), (W - al_get_text_width(font, timeResult)) - 20, hearts[2].y + 150, 0, timeResult);
-
-                matrix_validation();                                        //Drawing numbers in the Sudoku 
-                draw_area();                                                //Mesh drawing
-                show_heart(hearts, count_heart);                            //Show hearts
-                draw_numpad(numpad);                                        //Display numpad
-
-                //If an empty cell is selected, display a frame
-                if (show_frame)
-                    array_zero[idx].show(array_zero[idx].name_file, array_zero[idx].width, array_zero[idx].height, array_zero[idx].x, array_zero[idx].y);
-
-                //If the game is over
-                if (gameEnd) {
-                    //Drawing the result window
-                    al_draw_scaled_bitmap(box_result, 0, 0, al_get_bitmap_width(box_result), al_get_bitmap_height(box_result), W / 4, H / 4, W / 2, H / 3, 0);
-
-                    //Displaying the exit and restart button
-                    b_restart.show(b_restart.name_file, b_restart.width, b_restart.height, b_restart.x, b_restart.y);
-                    b_exitBox.show(b_exitBox.name_file, b_exitBox.width, b_exitBox.height, b_exitBox.x, b_exitBox.y);
-                    if (gameWIN) {
-                        //Let's write out that the player won
-                        al_draw_text(font, al_map_rgb(0, 0, 0), (W - al_get_text_width(font, "You Win")) / 2, 3 * H / 10, 0, "You Win");
-                    }
-                    if (gameLOSE) {
-                        //Write out that the player lost
-                        al_draw_text(font, al_map_rgb(0, 0, 0), (W - al_get_text_width(font, "You Lose")) / 2, 3 * H / 10, 0, "You Lose");
+                        G->show_frame = false;
                     }
-                    sprintf(timeResult, "Your time: %02d:%02d", minutes, seconds );
-                    al_draw_text(font, al_map_rgb(0, 0, 0), (W - al_get_text_width(font, timeResult)) / 2, H / 2.5, 0, timeResult); //Drawing of stopwatch in the box result
+                }
 
+                //Check if an empty cell has been selected
+                if (cell >= 0 && cellset_contains(&empty_cells, cell))
+                {
+                    G->selected = cell;
+                    G->show_frame = true;
                 }
-                al_flip_display();
+
+                //Record what this click changed in the undo journal
+                journal_record(&G->journal, grid_before, matrix_area, notes_before, G->notes.mask, G->count_clue - clue_before);
             }
-            if (event.timer.source == timeGame) {
-                if (!gameEnd) {
-                    //Time calculation
-                    time_count++;
-                    minutes = time_count / 60;
-                    seconds = time_count % 60;
-                    
+            else
+            {
+                int hit = widgets_hit(&G->widgets, x, y);  //The result box covers the widgets below it
+
+                //Check if the restart button is pressed
+                if (hit == BUTTON_RESTART)
+                {
+                    //Resetting everything
+                    G->count_clue = TOTAL_CLUE;
+                    G->count_heart = TOTAL_HEARTS;
+                    G->show_frame = false;
+                    if (G->has_board)
+                        memcpy(matrix_area, G->board, sizeof(matrix_area));
+                    int solution[9][9];
+                    bool banked = !G->has_board && newBoard(solution);
+                    if (G->has_board || banked)
+                        game_setup_board(G, banked ? solution : NULL);
+                    else
+                        game_request_board(G);
+                    G->hint_text = NULL;
+                    G->conflict_until = 0;
+                    notes_clear(&G->notes);
+                    journal_clear(&G->journal);
+                    G->gameEnd = false;
+                    G->gameWIN = false;
+                    G->gameLOSE = false;
+                    G->resultSaved = false;
+                    stopwatch_reset(&G->clock, 0);
                 }
-            }
-        }
 
-        //If the settings are accepted, adjust everything to fit the window size
-        if (change_set == true)
-        {
-            clue.width = W / 8;
-            clue.height = H / 8;
-            clue.x = W - clue.width - 10;
-            clue.y = H - clue.height - 25;
-
-            b_setting.width = W / 20;
-            b_setting.height = H / 20;
-            b_setting.x = W - b_setting.width - 5;
-            b_setting.y = 5;
-
-            b_exit.width = W / 20;
-            b_exit.height = H / 20;
-            b_exit.x = b_setting.x - b_exit.width - 20;
-            b_exit.y = b_setting.y;
-
-            int heart_width = W / 9;
-            int heart_height = H / 9;
-            for (int i = 0; i < count_heart; i++)
-            {
-                hearts[i].width = heart_width;
-                hearts[i].height = heart_width;
-                hearts[i].x = W - heart_width - 20;
-                hearts[i].y = 70 + (i * heart_height + 25);
+                //Press the exit button
+                if (hit == BUTTON_EXIT_BOX)
+                {
+                    game_leave(false);
+                    return;
+                }
             }
+        }
+    }
+}
 
-            b_restart.width = W / 12;
-            b_restart.height = H / 12;
-            b_restart.x = W / 3.5;
-            b_restart.y = H / 2.15;
-
-            b_exitBox.width = W / 18; 
-            b_exitBox.height = H / 18;
-            b_exitBox.x = 3 * W / 4.55;
-            b_exitBox.y = H / 2.1;
-
-            if (W == resolution[0][0])
-                fontSize = 25;
-            else if (W == resolution[1][0])
-                fontSize = 30;
-            else if (W == resolution[2][0])
-                fontSize = 34;
-            al_destroy_font(font);
-            font = al_load_ttf_font("Tenada.ttf", fontSize, 0);
-
-            generation_numpad();
-            size_array_zero = 0;
-            if (array_zero != NULL) {
-                free_ptr(array_zero);
-            }
-            array_zero = (struct CELL*)malloc(size * sizeof(struct CELL));
-            fillArrayZero();
-            change_set = false;
+/**
+ * @brief Obsługuje zdarzenie w grze i uaktualnia wynik oraz widżety.
+ *
+ * @param event Zdarzenie.
+ */
+//One event of the main loop; the state is complete again before it is published to the render thread
+void game_event(const ALLEGRO_EVENT* event)
+{
+    game_input(event);
+    if (scene_top() == SCENE_GAME)
+        game_update();
+}
 
+/**
+ * @brief Rysuje klatkę gry: tło, planszę, notatki, widżety i okno wyniku.
+ *
+ * Wywoływana przez wątek rysowania (render.h) dla migawki stanu gry.
+ *
+ * @param G Stan gry z migawki.
+ * @param grid Plansza z migawki.
+ * @param atlas Atlas małych cyfr notatek.
+ * @param L Układ ekranu z migawki.
+ */
+//Draw one frame of the game scene from a snapshot; nothing here changes the game state
+void game_draw(const struct GameScene* G, const int grid[9][9], const struct NotesAtlas* atlas, const struct Layout* L)
+{
+    ALLEGRO_FONT* font = scene_font(FONT_GAME, L);  //Resident font, reloaded only when its size changes
+    char count_clue_str[10];            //For conversion from int to char (string)
+    char timeResult[50];                //Stopwatch Text
+    unsigned int time_ms = stopwatch_ms(&G->clock);    //Elapsed time from the monotonic clock
+
+    sprintf(count_clue_str, "%d/%d", G->count_clue, TOTAL_CLUE);              //Convert from int to char (string)
+    texture_draw(G->background, 0, 0, L->width, L->height);                     //Draw background
+    struct Rect clue = L->game[BUTTON_CLUE];
+    al_draw_text(font, al_map_rgb(0, 0, 0), clue.x + 20, clue.y - 50, 0, count_clue_str);                                           //Draw text (number of prompts)
+    const char* status = G->pending_board ? "Generating a puzzle..." : G->pending_move >= 0 ? "Checking..." : G->pending_hint ? "Looking for a hint..." : G->hint_text;
+    if (status)
+        al_draw_text(font, al_map_rgb(0, 0, 0), L->width - 20, clue.y - 100, ALLEGRO_ALIGN_RIGHT, status);                          //Technique of the last hint or a pending request
+
+    //Drawing of stopwatch
+    sprintf(timeResult, "%02u:%02u", time_ms / 60000, time_ms / 1000 % 60);
+    al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - al_get_text_width(font, timeResult)) - 20, L->game[BUTTON_HEART + 2].y + 150, 0, timeResult);
+
+    matrix_validation(&G->widgets, grid, L);                    //Drawing numbers in the Sudoku 
+    if (al_get_time() < G->conflict_until) {
+        //Highlight the cells that clash with the rejected digit
+        for (int i = 0; i < 81; i++)
+            if (G->conflict_cells[i])
+                al_draw_filled_rectangle((i % 9) * L->cell_width, (i / 9) * L->cell_height, (i % 9 + 1) * L->cell_width, (i / 9 + 1) * L->cell_height, al_map_rgba(110, 0, 0, 110));
+    }
+    if (G->pending_move >= 0) {
+        //The move is waiting for the solver service
+        int i = G->pending_move;
+        al_draw_filled_rectangle((i % 9) * L->cell_width, (i / 9) * L->cell_height, (i % 9 + 1) * L->cell_width, (i / 9 + 1) * L->cell_height, al_map_rgba(0, 0, 110, 60));
+    }
+    notes_draw(&G->notes, atlas, grid, L->cell_width, L->cell_height);  //Pencil marks in one batch from the atlas
+    draw_area(L);                                               //Mesh drawing
+
+    //If an empty cell is selected, display a frame
+    if (G->show_frame) {
+        struct Rect frame = L->frames[G->selected];
+        texture_draw(G->frame_texture, frame.x, frame.y, frame.width, frame.height);
+    }
+
+    //Buttons, hearts, numpad and, once the game is over, the result box in one pass
+    widgets_draw(&G->widgets, font);
+
+    //If the game is over
+    if (G->gameEnd) {
+        if (G->gameWIN) {
+            //Let's write out that the player won
+            al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - al_get_text_width(font, "You Win")) / 2, 3 * L->height / 10, 0, "You Win");
         }
-
-    }
-    saveGame(count_clue, count_heart, minutes, seconds, time_count);
-    if (array_zero != NULL) {
-        free_ptr(array_zero);
+        if (G->gameLOSE) {
+            //Write out that the player lost
+            al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - al_get_text_width(font, "You Lose")) / 2, 3 * L->height / 10, 0, "You Lose");
+        }
+        sprintf(timeResult, "Your time: %02u:%02u", time_ms / 60000, time_ms / 1000 % 60);
+        al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - al_get_text_width(font, timeResult)) / 2, L->height / 2.5, 0, timeResult); //Drawing of stopwatch in the box result
     }
-    al_stop_timer(timer);
-    al_stop_timer(timeGame);
-    al_destroy_timer(timer);
-    al_destroy_timer(timeGame);
-    al_destroy_font(font);
-    al_destroy_bitmap(box_result);
-    al_destroy_bitmap(background);
-
-    return true;
 }
 
 #endif
@@ -0,0 +1,437 @@
+/**
+ * @file generator.h
+ * @brief Równoległy generator banku plansz (potok trzech etapów).
+ *
+ * Etap 1 wypełnia losową pełną planszę zgodnie z zasadami gry (wiersz, kolumna,
+ * kwadrat 3x3 i grupa pozycji z is_poz). Etap 2 usuwa cyfry w losowej kolejności,
+ * zachowując jednoznaczność rozwiązania, aż do losowej docelowej liczby podpowiedzi.
+ * Etap 3 ocenia trudność technikami logicznymi (rater.h) i zapisuje planszę do pliku
+ * odpowiedniego poziomu, dopóki nie zostanie osiągnięta żądana liczba plansz; plansze
+ * poziomów, które są już pełne, są odrzucane. Etapy są połączone ograniczonymi
+ * kolejkami, a każdy etap ma własną pulę wątków.
+ *
+ * Użycie: --generate <prefiks> <łatwe> <średnie> <trudne> [--threads N]
+ * Wynik: pliki <prefiks>_easy.txt, <prefiks>_mid.txt, <prefiks>_hard.txt (81 znaków na linię).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <allegro5/allegro5.h>
+
+#include "solver.h"
+#include "queue.h"
+#include "puzzleio.h"
+#include "rater.h"
+
+#ifndef GENERATOR
+#define GENERATOR
+
+/**
+ * @brief Liczba poziomów trudności w banku (łatwy, średni, trudny).
+ */
+#define BANK_LEVELS 3
+
+/**
+ * @brief Pojemność kolejek między etapami.
+ */
+#define GEN_QUEUE_SIZE 64
+
+/**
+ * @brief Nazwy plików poziomów trudności.
+ */
+const char* bank_level_names[BANK_LEVELS] = { "easy", "mid", "hard" };
+
+/**
+ * @struct GenItem
+ * @brief Plansza przekazywana między etapami potoku.
+ */
+struct GenItem {
+    unsigned char solution[81];     ///< Pełne rozwiązanie.
+    unsigned char puzzle[81];       ///< Plansza z usuniętymi cyframi.
+    int givens;                     ///< Liczba podpowiedzi.
+    int level;                      ///< Poziom trudności.
+};
+
+/**
+ * @struct GenStage
+ * @brief Statystyki etapu potoku.
+ */
+struct GenStage {
+    const char* name;       ///< Nazwa etapu.
+    int threads;            ///< Liczba wątków etapu.
+    long long items;        ///< Liczba przetworzonych plansz.
+    double busy;            ///< Łączny czas pracy wątków etapu (bez czekania na kolejki).
+};
+
+/**
+ * @struct Generator
+ * @brief Wspólny stan potoku.
+ */
+struct Generator {
+    struct BoundedQueue filled;         ///< Etap 1 -> etap 2.
+    struct BoundedQueue dug;            ///< Etap 2 -> etap 3.
+    struct GenStage stage[3];           ///< Statystyki etapów.
+    int target[BANK_LEVELS];            ///< Żądana liczba plansz na poziom.
+    int accepted[BANK_LEVELS];          ///< Zaakceptowane plansze na poziom.
+    long long rejected;                 ///< Plansze odrzucone (pełny kubełek).
+    FILE* output[BANK_LEVELS];          ///< Pliki wyjściowe poziomów.
+    bool stop;                          ///< Wszystkie kubełki są pełne (chronione przez mutex).
+    ALLEGRO_MUTEX* mutex;               ///< Chroni statystyki, kubełki i stop.
+};
+
+/**
+ * @struct GenWorker
+ * @brief Dane wątku potoku.
+ */
+struct GenWorker {
+    struct Generator* gen;  ///< Wspólny stan.
+    unsigned int seed;      ///< Stan generatora liczb losowych wątku.
+};
+
+/**
+ * @brief Generator liczb losowych xorshift32 (rand() nie jest bezpieczny wątkowo).
+ *
+ * @param state Stan generatora (różny od zera).
+ * @return Liczba losowa.
+ */
+static unsigned int gen_rand(unsigned int* state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/**
+ * @brief Losowo wypełnia planszę (przeszukiwanie z losową kolejnością cyfr).
+ */
+static bool fill_random(struct Solver* s, unsigned int* seed)
+{
+    int best = -1, best_count = 10;
+    unsigned int best_mask = 0;
+    for (int cell = 0; cell < 81; cell++) {
+        if (s->grid[cell])
+            continue;
+        unsigned int mask = solver_candidates(s, cell);
+        int n = bit_count(mask);
+        if (n < best_count) {
+            best = cell;
+            best_count = n;
+            best_mask = mask;
+        }
+    }
+    if (best < 0)
+        return true;
+
+    while (best_mask) {
+        // Losowy kandydat z maski
+        int pick = gen_rand(seed) % bit_count(best_mask);
+        unsigned int bit = best_mask & (~best_mask + 1);
+        while (pick--) {
+            unsigned int rest = best_mask & ~(bit | (bit - 1));
+            bit = rest & (~rest + 1);
+        }
+        best_mask &= ~bit;
+        solver_place(s, best, bit_digit(bit));
+        if (fill_random(s, seed))
+            return true;
+        solver_remove(s, best);
+    }
+    return false;
+}
+
+/**
+ * @brief Usuwa cyfry z pełnej planszy, zachowując jednoznaczność rozwiązania.
+ *
+ * @param item Plansza (solution musi być wypełnione).
+ * @param target Docelowa liczba podpowiedzi.
+ * @param seed Stan generatora liczb losowych.
+ */
+static void dig_puzzle(struct GenItem* item, int target, unsigned int* seed)
+{
+    int grid[9][9];
+    int order[81];
+    for (int i = 0; i < 81; i++) {
+        grid[i / 9][i % 9] = item->solution[i];
+        order[i] = i;
+    }
+    for (int i = 80; i > 0; i--) {
+        int j = gen_rand(seed) % (i + 1);
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+
+    int givens = 81;
+    for (int i = 0; i < 81 && givens > target; i++) {
+        int r = order[i] / 9, c = order[i] % 9;
+        int digit = grid[r][c];
+        grid[r][c] = 0;
+        if (count_solutions(grid, 2, NULL) == 1)
+            givens--;
+        else
+            grid[r][c] = digit;
+    }
+
+    for (int i = 0; i < 81; i++)
+        item->puzzle[i] = (unsigned char)grid[i / 9][i % 9];
+    item->givens = givens;
+}
+
+/**
+ * @brief Ocenia trudność planszy technikami logicznymi (rater.h).
+ *
+ * @param item Plansza do oceny.
+ * @return Poziom trudności (0 – łatwy, 1 – średni, 2 – trudny).
+ */
+int rate_puzzle(const struct GenItem* item)
+{
+    int grid[9][9];
+    for (int i = 0; i < 81; i++)
+        grid[i / 9][i % 9] = item->puzzle[i];
+    return logic_level(rate_logic(grid));
+}
+
+/**
+ * @brief Generuje jedną planszę zadanego poziomu przez losowanie z odrzucaniem.
+ *
+ * @param level Poziom trudności (0 – łatwy, 1 – średni, 2 – trudny).
+ * @param grid Tablica na planszę.
+ * @param seed Stan generatora liczb losowych.
+ * @param attempts Maksymalna liczba losowanych plansz.
+ * @param budget Budżet sprawdzany po każdej próbie (funkcja expired – czas, anulowanie) lub NULL;
+ *        po jego wyczerpaniu budget->aborted jest ustawione.
+ * @return true, jeśli trafiono w poziom; w przeciwnym razie grid zawiera ostatnią planszę.
+ */
+bool generate_puzzle(int level, int grid[9][9], unsigned int* seed, int attempts, struct SolverBudget* budget)
+{
+    struct GenItem item;
+    if (budget)
+        budget->aborted = false;
+    for (int n = 0; n < attempts; n++) {
+        struct Solver s;
+        memset(&s, 0, sizeof(s));
+        fill_random(&s, seed);
+        for (int i = 0; i < 81; i++)
+            item.solution[i] = (unsigned char)s.grid[i];
+        dig_puzzle(&item, 20 + gen_rand(seed) % 16, seed);
+        item.level = rate_puzzle(&item);
+        for (int i = 0; i < 81; i++)
+            grid[i / 9][i % 9] = item.puzzle[i];
+        if (item.level == level)
+            return true;
+        // Zawsze co najmniej jedna plansza; kolejna próba tylko w ramach budżetu
+        if (budget && budget->expired && budget->expired(budget->arg)) {
+            budget->aborted = true;
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sprawdza pod blokadą potoku, czy wszystkie kubełki są już pełne.
+ */
+static bool gen_stopped(struct Generator* gen)
+{
+    al_lock_mutex(gen->mutex);
+    bool stop = gen->stop;
+    al_unlock_mutex(gen->mutex);
+    return stop;
+}
+
+/**
+ * @brief Wątek etapu 1: wypełnianie pełnych plansz.
+ */
+static void* gen_fill_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    struct GenWorker* worker = arg;
+    struct Generator* gen = worker->gen;
+    struct GenItem item;
+    while (!gen_stopped(gen)) {
+        double start = al_get_time();
+        struct Solver s;
+        memset(&s, 0, sizeof(s));
+        fill_random(&s, &worker->seed);
+        for (int i = 0; i < 81; i++)
+            item.solution[i] = (unsigned char)s.grid[i];
+        double busy = al_get_time() - start;
+
+        al_lock_mutex(gen->mutex);
+        gen->stage[0].items++;
+        gen->stage[0].busy += busy;
+        al_unlock_mutex(gen->mutex);
+
+        if (!queue_push(&gen->filled, &item))
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wątek etapu 2: usuwanie cyfr ze sprawdzaniem jednoznaczności.
+ */
+static void* gen_dig_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    struct GenWorker* worker = arg;
+    struct Generator* gen = worker->gen;
+    struct GenItem item;
+    while (!gen_stopped(gen) && queue_pop(&gen->filled, &item)) {
+        double start = al_get_time();
+        dig_puzzle(&item, 20 + gen_rand(&worker->seed) % 16, &worker->seed);
+        double busy = al_get_time() - start;
+
+        al_lock_mutex(gen->mutex);
+        gen->stage[1].items++;
+        gen->stage[1].busy += busy;
+        al_unlock_mutex(gen->mutex);
+
+        if (!queue_push(&gen->dug, &item))
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wątek etapu 3: ocena trudności i zapis do kubełków.
+ */
+static void* gen_rate_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    struct GenWorker* worker = arg;
+    struct Generator* gen = worker->gen;
+    struct GenItem item;
+    while (!gen_stopped(gen) && queue_pop(&gen->dug, &item)) {
+        double start = al_get_time();
+        item.level = rate_puzzle(&item);
+        double busy = al_get_time() - start;
+
+        al_lock_mutex(gen->mutex);
+        gen->stage[2].items++;
+        gen->stage[2].busy += busy;
+        if (gen->accepted[item.level] < gen->target[item.level]) {
+            int grid[9][9];
+            for (int i = 0; i < 81; i++)
+                grid[i / 9][i % 9] = item.puzzle[i];
+            write_puzzle_line(gen->output[item.level], grid, '.');
+            gen->accepted[item.level]++;
+
+            bool full = true;
+            for (int i = 0; i < BANK_LEVELS; i++)
+                if (gen->accepted[i] < gen->target[i])
+                    full = false;
+            if (full && !gen->stop) {
+                gen->stop = true;
+                queue_close(&gen->filled);
+                queue_close(&gen->dug);
+            }
+        }
+        else {
+            gen->rejected++;
+        }
+        al_unlock_mutex(gen->mutex);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Punkt wejścia generatora banku (--generate).
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int generator_main(int argc, char** argv)
+{
+    if (argc < 6) {
+        fprintf(stderr, "Usage: %s --generate <prefix> <easy> <mid> <hard> [--threads N]\n", argv[0]);
+        return 1;
+    }
+    int threads = al_get_cpu_count();
+    for (int i = 6; i < argc; i++)
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+    if (threads < 3)
+        threads = 3;
+
+    struct Generator gen;
+    memset(&gen, 0, sizeof(gen));
+    char path[260];
+    for (int i = 0; i < BANK_LEVELS; i++) {
+        gen.target[i] = atoi(argv[3 + i]);
+        snprintf(path, sizeof(path), "%s_%s.txt", argv[2], bank_level_names[i]);
+        gen.output[i] = fopen(path, "wb");
+        if (!gen.output[i]) {
+            fprintf(stderr, "Unable to open %s for writing.\n", path);
+            return 1;
+        }
+    }
+
+    // Podział wątków: usuwanie cyfr (etap 2) jest najdroższe
+    gen.stage[0] = (struct GenStage){ "fill", threads / 6 > 1 ? threads / 6 : 1, 0, 0 };
+    gen.stage[2] = (struct GenStage){ "rate", threads / 6 > 1 ? threads / 6 : 1, 0, 0 };
+    gen.stage[1] = (struct GenStage){ "dig", threads - gen.stage[0].threads - gen.stage[2].threads, 0, 0 };
+
+    gen.mutex = al_create_mutex();
+    if (!queue_create(&gen.filled, sizeof(struct GenItem), GEN_QUEUE_SIZE) || !queue_create(&gen.dug, sizeof(struct GenItem), GEN_QUEUE_SIZE)) {
+        fprintf(stderr, "Cannot allocate generator queues.\n");
+        return 1;
+    }
+
+    void* (*procs[3])(ALLEGRO_THREAD*, void*) = { gen_fill_worker, gen_dig_worker, gen_rate_worker };
+    struct GenWorker* workers = calloc(threads, sizeof(struct GenWorker));
+    ALLEGRO_THREAD** handles = calloc(threads, sizeof(ALLEGRO_THREAD*));
+    if (!workers || !handles) {
+        fprintf(stderr, "Cannot allocate generator workers.\n");
+        return 1;
+    }
+
+    bool done = true;
+    for (int i = 0; i < BANK_LEVELS; i++)
+        if (gen.accepted[i] < gen.target[i])
+            done = false;
+    gen.stop = done;
+
+    double start = al_get_time();
+    int n = 0;
+    for (int stage = 0; stage < 3; stage++) {
+        for (int i = 0; i < gen.stage[stage].threads; i++, n++) {
+            workers[n].gen = &gen;
+            workers[n].seed = (unsigned int)time(NULL) * 2654435761u + n * 40503u + 1;
+            handles[n] = al_create_thread(procs[stage], &workers[n]);
+            al_start_thread(handles[n]);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        al_join_thread(handles[i], NULL);
+        al_destroy_thread(handles[i]);
+    }
+    double elapsed = al_get_time() - start;
+
+    printf("Generated %d easy, %d mid, %d hard puzzles in %.3f s (%lld rejected)\n",
+        gen.accepted[0], gen.accepted[1], gen.accepted[2], elapsed, gen.rejected);
+    for (int i = 0; i < 3; i++) {
+        const struct GenStage* stage = &gen.stage[i];
+        printf("  %-4s: %2d threads, %lld items, %.0f items/s, %.0f items/s per thread busy, utilization %.0f%%\n",
+            stage->name, stage->threads, stage->items, elapsed > 0 ? stage->items / elapsed : 0.0,
+            stage->busy > 0 ? stage->items / stage->busy : 0.0,
+            elapsed > 0 ? 100.0 * stage->busy / (stage->threads * elapsed) : 0.0);
+    }
+
+    for (int i = 0; i < BANK_LEVELS; i++)
+        fclose(gen.output[i]);
+    queue_destroy(&gen.filled);
+    queue_destroy(&gen.dug);
+    al_destroy_mutex(gen.mutex);
+    free(workers);
+    free(handles);
+    return 0;
+}
+
+#endif
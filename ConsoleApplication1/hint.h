@@ -0,0 +1,170 @@
+/**
+ * @file hint.h
+ * @brief Silnik podpowiedzi: najprostszy logiczny następny ruch.
+ *
+ * Silnik przechowuje stan kandydatów (struct Logic) przez całą grę: ruchy gracza
+ * aktualizują go przyrostowo, a kandydaci usunięci przy szukaniu poprzednich
+ * podpowiedzi pozostają usunięci. Podpowiedź to pierwsze wpisanie cyfry osiągnięte
+ * najprostszymi technikami (rater.h), więc jej koszt jest ograniczony liczbą kandydatów
+ * planszy i nie zależy od tego, jak trudna jest plansza – w wątku interfejsu nie działa
+ * żadne przeszukiwanie.
+ *
+ * Gdy logika nie wystarcza, podpowiedź pochodzi z rozwiązania planszy. Silnik sam
+ * niczego nie przeszukuje: rozwiązanie wyznacza usługa rozwiązywania (service.h),
+ * a gra przekazuje je silnikowi przez hint_set_solution.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "solver.h"
+#include "rater.h"
+
+#ifndef HINT
+#define HINT
+
+/**
+ * @struct Hint
+ * @brief Podpowiedź: komórka, cyfra i technika, która do niej prowadzi.
+ */
+struct Hint {
+    int row;                            ///< Wiersz komórki.
+    int column;                         ///< Kolumna komórki.
+    int digit;                          ///< Cyfra do wpisania.
+    enum LogicTechnique technique;      ///< Najtrudniejsza technika potrzebna do tego ruchu.
+};
+
+/**
+ * @struct HintEngine
+ * @brief Stan silnika podpowiedzi.
+ */
+struct HintEngine {
+    struct Logic logic;         ///< Kandydaci aktualnej planszy.
+    int solution[9][9];         ///< Rozwiązanie (ważne, gdy solved).
+    bool solved;                ///< Czy rozwiązanie jest znane.
+};
+
+/**
+ * @brief Uruchamia silnik podpowiedzi dla nowej planszy.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param grid Aktualna plansza.
+ */
+void hint_start(struct HintEngine* engine, const int grid[9][9])
+{
+    logic_init(&engine->logic, grid);
+    engine->solved = false;
+}
+
+/**
+ * @brief Odbudowuje kandydatów po cofnięciu lub ponowieniu ruchu na tej samej planszy.
+ *
+ * Wpisane cyfry zawsze zgadzają się z rozwiązaniem, więc znane rozwiązanie pozostaje ważne.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param grid Aktualna plansza.
+ */
+void hint_reset(struct HintEngine* engine, const int grid[9][9])
+{
+    logic_init(&engine->logic, grid);
+}
+
+/**
+ * @brief Przekazuje silnikowi jedyne rozwiązanie planszy.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param solution Rozwiązanie.
+ */
+void hint_set_solution(struct HintEngine* engine, const int solution[9][9])
+{
+    memcpy(engine->solution, solution, sizeof(engine->solution));
+    engine->solved = true;
+}
+
+/**
+ * @brief Sprawdza, czy silnik zna już rozwiązanie planszy.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @return true, jeśli rozwiązanie zostało przekazane przez hint_set_solution.
+ */
+bool hint_solved(const struct HintEngine* engine)
+{
+    return engine->solved;
+}
+
+/**
+ * @brief Uwzględnia cyfrę wpisaną przez gracza.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Wpisana cyfra.
+ */
+void hint_place(struct HintEngine* engine, int row, int column, int digit)
+{
+    int cell = row * 9 + column;
+    if (engine->logic.grid[cell] == 0)
+        logic_place(&engine->logic, cell, digit);
+}
+
+/**
+ * @brief Zwraca cyfrę rozwiązania w komórce, jeśli rozwiązanie jest już znane.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @return Cyfra rozwiązania lub 0, jeśli rozwiązanie nie jest jeszcze znane.
+ */
+int hint_solution(const struct HintEngine* engine, int row, int column)
+{
+    return engine->solved ? engine->solution[row][column] : 0;
+}
+
+/**
+ * @brief Znajduje najprostszy następny ruch i uwzględnia go w stanie silnika.
+ *
+ * @param engine Silnik podpowiedzi.
+ * @param hint Znaleziona podpowiedź; gdy logika nie wystarcza, a rozwiązanie nie jest
+ *        znane – komórka, dla której trzeba je wyznaczyć (digit 0; row -1 dla pełnej planszy).
+ * @return false, jeśli plansza jest pełna albo logika nie wystarcza, a rozwiązanie
+ *         nie jest jeszcze znane.
+ */
+bool hint_next(struct HintEngine* engine, struct Hint* hint)
+{
+    struct Logic* L = &engine->logic;
+    struct LogicMove move;
+    hint->row = -1;
+    hint->column = -1;
+    hint->digit = 0;
+    hint->technique = LOGIC_HIDDEN_SINGLE;
+
+    // Każdy krok bez wpisania cyfry usuwa co najmniej jednego kandydata
+    while (logic_step(L, &move)) {
+        if (move.technique > hint->technique)
+            hint->technique = move.technique;
+        if (move.cell >= 0) {
+            hint->row = move.cell / 9;
+            hint->column = move.cell % 9;
+            hint->digit = move.digit;
+            return true;
+        }
+    }
+    if (L->empty == 0)
+        return false;
+
+    // Logika nie wystarcza: komórka z najmniejszą liczbą kandydatów z rozwiązania
+    int best = -1;
+    for (int cell = 0; cell < 81; cell++)
+        if (!L->grid[cell] && (best < 0 || bit_count(L->cand[cell]) < bit_count(L->cand[best])))
+            best = cell;
+    hint->row = best / 9;
+    hint->column = best % 9;
+    hint->technique = LOGIC_GUESS;
+    if (!engine->solved)
+        return false;
+    hint->digit = engine->solution[hint->row][hint->column];
+    logic_place(L, best, hint->digit);
+    return true;
+}
+
+#endif
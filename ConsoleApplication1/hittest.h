@@ -0,0 +1,133 @@
+/**
+ * @file hittest.h
+ * @brief Tablica trafień przycisków ekranu.
+ *
+ * Prostokąty przycisków ekranu zapisywane są raz, a okno dzielone jest na siatkę
+ * HIT_GRID x HIT_GRID kubełków; każdy kubełek ma maskę prostokątów, które go
+ * przecinają. Kliknięcie wybiera kubełek dwoma dzieleniami i sprawdza tylko
+ * prostokąty z jego maski, więc koszt nie rośnie z liczbą przycisków ekranu.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "layout.h"
+
+#ifndef HITTEST
+#define HITTEST
+
+/**
+ * @brief Maksymalna liczba prostokątów w tablicy (bity maski kubełka).
+ */
+#define HIT_MAX 32
+
+/**
+ * @brief Liczba kubełków w wierszu i kolumnie siatki.
+ */
+#define HIT_GRID 8
+
+/**
+ * @struct HitRect
+ * @brief Prostokąt przycisku i jego identyfikator.
+ */
+struct HitRect {
+    float x;        ///< Współrzędna x.
+    float y;        ///< Współrzędna y.
+    float width;    ///< Szerokość.
+    float height;   ///< Wysokość.
+    int id;         ///< Identyfikator zwracany przez hit_test.
+};
+
+/**
+ * @struct HitTable
+ * @brief Prostokąty ekranu i siatka kubełków.
+ */
+struct HitTable {
+    struct HitRect rects[HIT_MAX];              ///< Prostokąty w kolejności dodania.
+    int count;                                  ///< Liczba prostokątów.
+    float bucket_width;                         ///< Szerokość kubełka.
+    float bucket_height;                        ///< Wysokość kubełka.
+    uint32_t buckets[HIT_GRID * HIT_GRID];      ///< Maski prostokątów przecinających kubełki.
+};
+
+/**
+ * @brief Czyści tablicę dla okna o zadanym rozmiarze.
+ *
+ * @param table Tablica trafień.
+ * @param width Szerokość okna.
+ * @param height Wysokość okna.
+ */
+void hit_clear(struct HitTable* table, int width, int height)
+{
+    memset(table, 0, sizeof(struct HitTable));
+    table->bucket_width = (float)width / HIT_GRID;
+    table->bucket_height = (float)height / HIT_GRID;
+}
+
+/**
+ * @brief Zwraca indeks kubełka dla współrzędnej, obcięty do siatki.
+ */
+static int hit_bucket(float v, float size)
+{
+    int b = (int)(v / size);
+    return b < 0 ? 0 : b >= HIT_GRID ? HIT_GRID - 1 : b;
+}
+
+/**
+ * @brief Dodaje prostokąt do tablicy.
+ *
+ * @param table Tablica trafień.
+ * @param x Współrzędna x.
+ * @param y Współrzędna y.
+ * @param width Szerokość.
+ * @param height Wysokość.
+ * @param id Identyfikator prostokąta.
+ */
+void hit_add(struct HitTable* table, float x, float y, float width, float height, int id)
+{
+    if (table->count == HIT_MAX || width <= 0 || height <= 0)
+        return;
+    table->rects[table->count] = (struct HitRect){ x, y, width, height, id };
+    int x0 = hit_bucket(x, table->bucket_width), x1 = hit_bucket(x + width, table->bucket_width);
+    int y0 = hit_bucket(y, table->bucket_height), y1 = hit_bucket(y + height, table->bucket_height);
+    for (int by = y0; by <= y1; by++)
+        for (int bx = x0; bx <= x1; bx++)
+            table->buckets[by * HIT_GRID + bx] |= 1u << table->count;
+    table->count++;
+}
+
+/**
+ * @brief Dodaje prostokąt z tabeli układu do tablicy.
+ *
+ * @param table Tablica trafień.
+ * @param rect Prostokąt.
+ * @param id Identyfikator prostokąta.
+ */
+void hit_add_rect(struct HitTable* table, struct Rect rect, int id)
+{
+    hit_add(table, rect.x, rect.y, rect.width, rect.height, id);
+}
+
+/**
+ * @brief Znajduje prostokąt pod wskazanym punktem.
+ *
+ * @param table Tablica trafień.
+ * @param x Współrzędna x punktu.
+ * @param y Współrzędna y punktu.
+ * @return Identyfikator ostatnio dodanego prostokąta zawierającego punkt lub -1.
+ */
+int hit_test(const struct HitTable* table, float x, float y)
+{
+    int id = -1;
+    if (table->count == 0 || x < 0 || y < 0)
+        return id;
+    uint32_t mask = table->buckets[hit_bucket(y, table->bucket_height) * HIT_GRID + hit_bucket(x, table->bucket_width)];
+    for (int i = 0; mask; i++, mask >>= 1) {
+        const struct HitRect* r = &table->rects[i];
+        if ((mask & 1) && x >= r->x && x < r->x + r->width && y >= r->y && y < r->y + r->height)
+            id = r->id;
+    }
+    return id;
+}
+
+#endif
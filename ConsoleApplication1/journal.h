@@ -0,0 +1,185 @@
+/**
+ * @file journal.h
+ * @brief Dziennik cofania i ponawiania ruchów w stałym buforze cyklicznym.
+ *
+ * Każda akcja gracza (wpisanie cyfry, podpowiedź, zmiana notatek) zapisywana jest jako
+ * grupa zwięzłych rekordów różnicowych – po jednym na zmienioną komórkę, 6 bajtów każdy:
+ * indeks komórki, stara i nowa cyfra, XOR maski notatek i zmiana liczby podpowiedzi.
+ * Pierwszy rekord grupy ma flagę JOURNAL_BEGIN. Po zapełnieniu bufora najstarsze grupy
+ * są nadpisywane w całości.
+ *
+ * Błędne ruchy nie trafiają do dziennika: nie zmieniają planszy, a utracone serce
+ * pozostaje utracone, więc cofanie nie pozwala bezkarnie sprawdzać cyfr.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef JOURNAL
+#define JOURNAL
+
+/**
+ * @brief Pojemność dziennika (liczba rekordów).
+ */
+#define JOURNAL_SIZE 512
+
+/**
+ * @brief Maksymalna liczba rekordów jednej akcji (każda komórka co najwyżej raz).
+ */
+#define JOURNAL_GROUP_MAX 81
+
+/**
+ * @brief Flaga pierwszego rekordu akcji.
+ */
+#define JOURNAL_BEGIN 1
+
+/**
+ * @struct JournalEntry
+ * @brief Zmiana jednej komórki.
+ */
+struct JournalEntry {
+    uint8_t cell;       ///< Indeks komórki (0-80).
+    uint8_t values;     ///< Stara cyfra (4 starsze bity) i nowa cyfra (4 młodsze bity).
+    uint16_t notes;     ///< XOR maski notatek przed i po akcji.
+    int8_t clues;       ///< Zmiana liczby podpowiedzi (tylko w pierwszym rekordzie akcji).
+    uint8_t flags;      ///< JOURNAL_BEGIN dla pierwszego rekordu akcji.
+};
+
+/**
+ * @struct Journal
+ * @brief Bufor cykliczny rekordów: count rekordów do cofnięcia przed head, redo do ponowienia od head.
+ */
+struct Journal {
+    struct JournalEntry entries[JOURNAL_SIZE];  ///< Rekordy.
+    uint16_t head;                              ///< Pozycja następnego zapisu.
+    uint16_t count;                             ///< Liczba rekordów do cofnięcia.
+    uint16_t redo;                              ///< Liczba rekordów do ponowienia.
+    uint16_t reserved;                          ///< Wyrównanie.
+};
+
+/**
+ * @brief Czyści dziennik.
+ *
+ * @param journal Dziennik.
+ */
+void journal_clear(struct Journal* journal)
+{
+    memset(journal, 0, sizeof(struct Journal));
+}
+
+/**
+ * @brief Dopisuje rekord, w razie potrzeby usuwając najstarszą grupę.
+ */
+static void journal_push(struct Journal* journal, struct JournalEntry entry)
+{
+    if (journal->count == JOURNAL_SIZE) {
+        // Usunięcie całej najstarszej grupy
+        int tail = (journal->head + JOURNAL_SIZE - journal->count) % JOURNAL_SIZE;
+        do {
+            tail = (tail + 1) % JOURNAL_SIZE;
+            journal->count--;
+        } while (journal->count > 0 && !(journal->entries[tail].flags & JOURNAL_BEGIN));
+    }
+    journal->entries[journal->head] = entry;
+    journal->head = (uint16_t)((journal->head + 1) % JOURNAL_SIZE);
+    journal->count++;
+}
+
+/**
+ * @brief Zapisuje akcję jako różnicę stanu przed i po niej.
+ *
+ * @param journal Dziennik.
+ * @param before Plansza przed akcją.
+ * @param after Plansza po akcji.
+ * @param notes_before Notatki przed akcją.
+ * @param notes_after Notatki po akcji.
+ * @param clues Zmiana liczby podpowiedzi.
+ * @return Liczba zapisanych rekordów (0, jeśli akcja niczego nie zmieniła).
+ */
+int journal_record(struct Journal* journal, const int before[9][9], const int after[9][9],
+    const unsigned short notes_before[81], const unsigned short notes_after[81], int clues)
+{
+    int n = 0;
+    for (int cell = 0; cell < 81; cell++) {
+        int old_value = before[cell / 9][cell % 9], new_value = after[cell / 9][cell % 9];
+        unsigned short notes = notes_before[cell] ^ notes_after[cell];
+        if (old_value == new_value && notes == 0)
+            continue;
+        if (n == 0)
+            journal->redo = 0;
+        struct JournalEntry entry = { (uint8_t)cell, (uint8_t)(old_value << 4 | new_value), notes,
+            (int8_t)(n == 0 ? clues : 0), (uint8_t)(n == 0 ? JOURNAL_BEGIN : 0) };
+        journal_push(journal, entry);
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Zdejmuje ostatnią akcję do cofnięcia.
+ *
+ * @param journal Dziennik.
+ * @param out Tablica na rekordy akcji (co najmniej JOURNAL_GROUP_MAX), od najnowszego.
+ * @return Liczba rekordów (0, jeśli nie ma czego cofnąć).
+ */
+int journal_undo(struct Journal* journal, struct JournalEntry out[JOURNAL_GROUP_MAX])
+{
+    int n = 0;
+    while (journal->count > 0 && n < JOURNAL_GROUP_MAX) {
+        journal->head = (uint16_t)((journal->head + JOURNAL_SIZE - 1) % JOURNAL_SIZE);
+        journal->count--;
+        journal->redo++;
+        out[n] = journal->entries[journal->head];
+        if (out[n++].flags & JOURNAL_BEGIN)
+            break;
+    }
+    return n;
+}
+
+/**
+ * @brief Sprawdza dziennik wczytany z pliku, zanim zostanie użyty.
+ *
+ * Indeksy bufora, liczniki i rekordy do cofnięcia i ponowienia muszą mieścić się
+ * w zakresach, bo journal_undo, journal_redo i applyJournal indeksują nimi tablice.
+ *
+ * @param journal Dziennik.
+ * @return true, jeśli dziennik jest spójny.
+ */
+bool journal_valid(const struct Journal* journal)
+{
+    if (journal->head >= JOURNAL_SIZE || journal->count > JOURNAL_SIZE || journal->redo > JOURNAL_SIZE ||
+        journal->count + journal->redo > JOURNAL_SIZE)
+        return false;
+    int first = (journal->head + JOURNAL_SIZE - journal->count) % JOURNAL_SIZE;
+    for (int i = 0; i < journal->count + journal->redo; i++) {
+        const struct JournalEntry* entry = &journal->entries[(first + i) % JOURNAL_SIZE];
+        if (entry->cell >= 81 || (entry->values >> 4) > 9 || (entry->values & 0xF) > 9 || entry->notes > 0x1FF)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Pobiera następną akcję do ponowienia.
+ *
+ * @param journal Dziennik.
+ * @param out Tablica na rekordy akcji (co najmniej JOURNAL_GROUP_MAX), od najstarszego.
+ * @return Liczba rekordów (0, jeśli nie ma czego ponowić).
+ */
+int journal_redo(struct Journal* journal, struct JournalEntry out[JOURNAL_GROUP_MAX])
+{
+    int n = 0;
+    while (journal->redo > 0 && n < JOURNAL_GROUP_MAX) {
+        struct JournalEntry entry = journal->entries[journal->head];
+        if (n > 0 && (entry.flags & JOURNAL_BEGIN))
+            break;
+        out[n++] = entry;
+        journal->head = (uint16_t)((journal->head + 1) % JOURNAL_SIZE);
+        journal->count++;
+        journal->redo--;
+    }
+    return n;
+}
+
+#endif
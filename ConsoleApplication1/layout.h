@@ -0,0 +1,223 @@
+/**
+ * @file layout.h
+ * @brief Układ ekranów gry, menu i ustawień wyliczany z rozmiaru okna.
+ *
+ * Wszystkie prostokąty przycisków, cyfr i komórek planszy wyliczane są raz po zmianie
+ * rozmiaru okna do jednej płaskiej tabeli (struct Layout), z której czytają wszystkie
+ * ekrany. Współczynniki, które wcześniej były dobierane osobno dla każdej rozdzielczości
+ * z tablicy resolution, są interpolowane liniowo między tymi rozdzielczościami, więc
+ * dla nich układ się nie zmienia, a działa też dla dowolnego innego rozmiaru okna.
+ */
+
+#include "structs.h"
+#include "define.h"
+
+#ifndef LAYOUT
+#define LAYOUT
+
+/**
+ * @struct Rect
+ * @brief Prostokąt na ekranie.
+ */
+struct Rect {
+    float x;        ///< Współrzędna x.
+    float y;        ///< Współrzędna y.
+    float width;    ///< Szerokość.
+    float height;   ///< Wysokość.
+};
+
+/**
+ * @brief Widżety ekranu gry (indeksy w Layout::game i w tablicy widżetów, w kolejności rysowania).
+ */
+enum GameButton {
+    BUTTON_NUMPAD = 0,      ///< Cyfry 1-9 klawiatury numerycznej (BUTTON_NUMPAD + i).
+    BUTTON_CLUE = 9,        ///< Podpowiedź.
+    BUTTON_SETTING,         ///< Ustawienia.
+    BUTTON_EXIT,            ///< Wyjście z zapisem.
+    BUTTON_NOTES,           ///< Tryb notatek.
+    BUTTON_FILL,            ///< Wypełnienie notatek.
+    BUTTON_UNDO,            ///< Cofnięcie.
+    BUTTON_REDO,            ///< Ponowienie.
+    BUTTON_HEART,           ///< Serca (BUTTON_HEART + i).
+    BUTTON_RESULT = BUTTON_HEART + 3,   ///< Okno wyniku.
+    BUTTON_RESTART,         ///< Nowa gra w oknie wyniku.
+    BUTTON_EXIT_BOX,        ///< Wyjście w oknie wyniku.
+    BUTTON_COUNT            ///< Liczba widżetów.
+};
+
+/**
+ * @brief Widżety menu (indeksy w Layout::menu i w tablicy widżetów).
+ */
+enum MenuButton {
+    MENU_START,             ///< Start.
+    MENU_CONTINUE,          ///< Kontynuacja.
+    MENU_STATS,             ///< Statystyki.
+    MENU_IMPORT,            ///< Import planszy.
+    MENU_EASY,              ///< Poziom łatwy.
+    MENU_MID,               ///< Poziom średni.
+    MENU_HARD,              ///< Poziom trudny.
+    MENU_BACK,              ///< Powrót.
+    MENU_SLOT,              ///< Wiersz slotu zapisu (MENU_SLOT + numer slotu).
+    MENU_COUNT = MENU_SLOT + SAVE_SLOTS     ///< Liczba prostokątów menu.
+};
+
+/**
+ * @brief Widżety ustawień (indeksy w Layout::setting i w tablicy widżetów, w kolejności rysowania).
+ */
+enum SettingButton {
+    SETTING_ACCEPT,         ///< Akceptacja.
+    SETTING_CANCEL,         ///< Anulowanie.
+    SETTING_RIGHT,          ///< Następna rozdzielczość.
+    SETTING_LEFT,           ///< Poprzednia rozdzielczość.
+    SETTING_TRACK,          ///< Tło suwaka głośności.
+    SETTING_SLIDER,         ///< Suwak głośności (x zależy od głośności).
+    SETTING_COUNT           ///< Liczba widżetów.
+};
+
+/**
+ * @struct Layout
+ * @brief Tabela układu wszystkich ekranów dla aktualnego rozmiaru okna.
+ */
+struct Layout {
+    int width;                          ///< Szerokość okna.
+    int height;                         ///< Wysokość okna.
+
+    float cell_width;                   ///< Odstęp kolumn siatki planszy.
+    float cell_height;                  ///< Odstęp wierszy siatki planszy.
+    float grid_width;                   ///< Długość poziomych linii siatki.
+    float grid_height;                  ///< Długość pionowych linii siatki.
+    struct Rect digits[81];             ///< Cyfry komórek planszy.
+    struct Rect frames[81];             ///< Ramki zaznaczenia komórek planszy.
+    struct Rect game[BUTTON_COUNT];     ///< Widżety ekranu gry.
+    int font_size;                      ///< Rozmiar czcionki ekranu gry.
+    int note_glyph;                     ///< Rozmiar cyfry notatki.
+
+    struct Rect menu[MENU_COUNT];       ///< Przyciski i wiersze slotów menu.
+
+    struct Rect panel;                  ///< Okno ustawień.
+    struct Rect setting[SETTING_COUNT]; ///< Widżety ustawień.
+    int setting_font;                   ///< Rozmiar czcionki ustawień.
+    int song_font;                      ///< Rozmiar czcionki nazwy utworu.
+};
+
+/**
+ * @brief Układ dla aktualnego rozmiaru okna.
+ */
+struct Layout layout;
+
+/**
+ * @brief Interpoluje współczynnik zadany dla rozdzielczości z tablicy resolution.
+ *
+ * @param values Wartości dla kolejnych rozdzielczości.
+ * @param size Rozmiar okna wzdłuż osi.
+ * @param axis 0 – szerokość, 1 – wysokość.
+ * @return Wartość interpolowana liniowo (poza zakresem – wartość skrajna).
+ */
+static float layout_lerp(const float values[3], float size, int axis)
+{
+    if (size <= resolution[0][axis])
+        return values[0];
+    for (int k = 1; k < 3; k++) {
+        if (size <= resolution[k][axis]) {
+            float t = (size - resolution[k - 1][axis]) / (resolution[k][axis] - resolution[k - 1][axis]);
+            return values[k - 1] + t * (values[k] - values[k - 1]);
+        }
+    }
+    return values[2];
+}
+
+/**
+ * @brief Wylicza układ wszystkich ekranów dla rozmiaru okna.
+ *
+ * @param L Tabela układu.
+ * @param width Szerokość okna.
+ * @param height Wysokość okna.
+ */
+void layout_compute(struct Layout* L, int width, int height)
+{
+    static const float digit_div[3] = { 13, 12.5f, 12 };
+    static const float digit_gap_x[3] = { 10, 10, 7 };
+    static const float digit_gap_y[3] = { 7, 5, 3 };
+    static const float frame_div_x[3] = { 10.74f, 10.9756f, 10.752688f };
+    static const float frame_div_y[3] = { 11.61f, 11.53846f, 11.6279f };
+    static const float numpad_x[3] = { 150, 160, 170 };
+    static const float numpad_y[3] = { 130, 160, 180 };
+    static const float game_font[3] = { 25, 30, 34 };
+    static const float setting_font[3] = { 25, 29, 32 };
+    static const float song_font[3] = { 17, 21, 24 };
+
+    float W = (float)width, H = (float)height;
+    L->width = width;
+    L->height = height;
+
+    // Plansza
+    L->cell_width = W / 10.9f;
+    L->cell_height = H / 11.5f;
+    L->grid_width = W / 1.2129f;
+    L->grid_height = H / 1.28f;
+    float dw = W / layout_lerp(digit_div, W, 0), dh = H / layout_lerp(digit_div, H, 1);
+    float gx = layout_lerp(digit_gap_x, W, 0), gy = layout_lerp(digit_gap_y, H, 1);
+    float fw = W / layout_lerp(frame_div_x, W, 0), fh = H / layout_lerp(frame_div_y, H, 1);
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            L->digits[i * 9 + j] = (struct Rect){ j * (dw + gx) + W / 90, i * (dh + gy) + H / 100, dw, dh };
+            L->frames[i * 9 + j] = (struct Rect){ j * L->cell_width, i * L->cell_height, fw, fh };
+        }
+    }
+    float cell = L->cell_width < L->cell_height ? L->cell_width : L->cell_height;
+    L->note_glyph = (int)(cell / 3) - 2;
+
+    // Klawiatura numeryczna: 5 cyfr w dolnym rzędzie, 4 nad nimi
+    float nx = layout_lerp(numpad_x, W, 0), ny = layout_lerp(numpad_y, H, 1);
+    for (int i = 0, j = 0, row = 1; i < 9; i++, j++) {
+        if (j > 4) { row = 2; j = 1; }
+        L->game[BUTTON_NUMPAD + i] = (struct Rect){ nx + j * (dw + 20), H - ny / row, dw, dh };
+    }
+
+    // Przyciski ekranu gry
+    struct Rect* g = L->game;
+    g[BUTTON_CLUE] = (struct Rect){ W - W / 8 - 10, H - H / 8 - 25, W / 8, H / 8 };
+    g[BUTTON_SETTING] = (struct Rect){ W - W / 20 - 5, 5, W / 20, H / 20 };
+    g[BUTTON_EXIT] = (struct Rect){ g[BUTTON_SETTING].x - W / 20 - 20, 5, W / 20, H / 20 };
+    g[BUTTON_NOTES] = (struct Rect){ 10, g[BUTTON_NUMPAD].y, g[BUTTON_NUMPAD].x - 20, dh };
+    g[BUTTON_FILL] = (struct Rect){ 10, g[BUTTON_NUMPAD + 5].y, g[BUTTON_NUMPAD].x - 20, dh };
+    float ux = g[BUTTON_NUMPAD + 4].x + dw + 15;
+    g[BUTTON_UNDO] = (struct Rect){ ux, g[BUTTON_NUMPAD].y, g[BUTTON_CLUE].x - ux - 15, dh };
+    g[BUTTON_REDO] = (struct Rect){ ux, g[BUTTON_NUMPAD + 5].y, g[BUTTON_CLUE].x - ux - 15, dh };
+    g[BUTTON_RESTART] = (struct Rect){ W / 3.5f, H / 2.15f, W / 12, H / 12 };
+    g[BUTTON_EXIT_BOX] = (struct Rect){ 3 * W / 4.55f, H / 2.1f, W / 18, H / 18 };
+    for (int i = 0; i < 3; i++)
+        g[BUTTON_HEART + i] = (struct Rect){ W - W / 9 - 20, 70 + i * (H / 9) + 25, W / 9, H / 9 };
+    g[BUTTON_RESULT] = (struct Rect){ W / 4, H / 4, W / 2, H / 3 };
+    L->font_size = (int)(layout_lerp(game_font, W, 0) + 0.5f);
+
+    // Menu
+    struct Rect* m = L->menu;
+    float bw = W / 5, bh = H / 11;
+    m[MENU_START] = (struct Rect){ W / 2 - bw / 2, H / 1.25f - bh / 2 - 50, bw, bh };
+    m[MENU_CONTINUE] = (struct Rect){ m[MENU_START].x, m[MENU_START].y + W / 9, bw, bh };
+    m[MENU_EASY] = (struct Rect){ W / 2 - bw / 2, H / 1.25f - bh / 2 - 100, bw, bh };
+    m[MENU_MID] = (struct Rect){ m[MENU_EASY].x, m[MENU_EASY].y + W / 9, bw, bh };
+    m[MENU_HARD] = (struct Rect){ m[MENU_EASY].x, m[MENU_MID].y + W / 9, bw, bh };
+    m[MENU_STATS] = (struct Rect){ 20, H - H / 15 - 20, W / 5, H / 15 };
+    m[MENU_IMPORT] = (struct Rect){ W - W / 5 - 20, m[MENU_STATS].y, W / 5, H / 15 };
+    m[MENU_BACK] = (struct Rect){ 20, 20, W / 20, H / 20 };
+    for (int i = 0; i < SAVE_SLOTS; i++)
+        m[MENU_SLOT + i] = (struct Rect){ W / 2 - W / 2.8f, H / 3 + i * (H / 12 + 10), W / 1.4f, H / 12 };
+
+    // Ustawienia
+    float pw = (float)(int)(W / 1.5f), ph = (float)(int)(H / 2.5f);
+    L->panel = (struct Rect){ W / 2 - pw / 2, H / 2 - ph / 2, pw, ph };
+    struct Rect* s = L->setting;
+    float px = L->panel.x, py = L->panel.y;
+    s[SETTING_ACCEPT] = (struct Rect){ px + pw - pw / 5 - 20, py + ph - ph / 7 - 20, pw / 5, ph / 7 };
+    s[SETTING_CANCEL] = (struct Rect){ px + 20, s[SETTING_ACCEPT].y, pw / 5, ph / 7 };
+    s[SETTING_LEFT] = (struct Rect){ (px + pw) / 2 + 90, py + W / 12, pw / 20, ph / 18 };
+    s[SETTING_RIGHT] = (struct Rect){ s[SETTING_LEFT].x + 160, s[SETTING_LEFT].y, pw / 20, ph / 18 };
+    s[SETTING_TRACK] = (struct Rect){ (px + pw) / 2 + 100, s[SETTING_LEFT].y + 60, pw / 3, ph / 50 };
+    s[SETTING_SLIDER] = (struct Rect){ s[SETTING_TRACK].x, s[SETTING_TRACK].y - 3, pw / 30, ph / 22 };
+    L->setting_font = (int)(layout_lerp(setting_font, W, 0) + 0.5f);
+    L->song_font = (int)(layout_lerp(song_font, W, 0) + 0.5f);
+}
+
+#endif
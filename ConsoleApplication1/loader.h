@@ -0,0 +1,339 @@
+/**
+ * @file loader.h
+ * @brief Równoległe wczytywanie zasobów przy starcie programu.
+ *
+ * Wątki robocze dekodują obrazy scen do bitmap w pamięci (ALLEGRO_MEMORY_BITMAP),
+ * wczytują plik czcionki do bufora i otwierają strumień pierwszego utworu. Wątek okna tylko
+ * przenosi gotowe bitmapy do pamięci karty graficznej (al_convert_bitmap) i dodaje
+ * je do pamięci podręcznej tekstur. Zasoby menu są na początku kolejki, więc menu
+ * może narysować pierwszą klatkę, gdy tylko one są gotowe, a reszta wczytuje się
+ * w czasie, gdy menu jest już widoczne.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_image.h>
+#include <allegro5/allegro_audio.h>
+
+#include "assets.h"
+#include "texture.h"
+#include "sound.h"
+
+#ifndef LOADER
+#define LOADER
+
+/**
+ * @brief Maksymalna liczba zadań wczytywania.
+ */
+#define LOADER_MAX 48
+
+/**
+ * @brief Maksymalna liczba wątków roboczych.
+ */
+#define LOADER_THREADS 4
+
+/**
+ * @brief Rodzaje zasobów.
+ */
+enum AssetKind {
+    ASSET_IMAGE,            ///< Obraz (tekstura).
+    ASSET_FONT,             ///< Plik czcionki wczytany do pamięci.
+    ASSET_MUSIC             ///< Utwór muzyki w tle (strumień).
+};
+
+/**
+ * @brief Stan zadania wczytywania.
+ */
+enum AssetState {
+    ASSET_PENDING,          ///< Czeka na wątek roboczy.
+    ASSET_DECODING,         ///< Dekodowane przez wątek roboczy.
+    ASSET_DECODED,          ///< Zdekodowane, czeka na wątek okna.
+    ASSET_DONE              ///< Przekazane do pamięci podręcznej tekstur lub modułu dźwięku.
+};
+
+/**
+ * @struct AssetJob
+ * @brief Jeden zasób do wczytania.
+ */
+struct AssetJob {
+    enum AssetId id;            ///< Zasób.
+    enum AssetKind kind;        ///< Rodzaj zasobu.
+    int group;                  ///< Grupa (scena), na którą można czekać, lub -1.
+    enum AssetState state;      ///< Stan (chroniony muteksem).
+    ALLEGRO_BITMAP* bitmap;     ///< Bitmapa w pamięci (ASSET_IMAGE).
+    ALLEGRO_AUDIO_STREAM* stream;   ///< Otwarty strumień (ASSET_MUSIC).
+    void* data;                 ///< Zawartość pliku (ASSET_FONT).
+    size_t size;                ///< Rozmiar zawartości pliku.
+};
+
+/**
+ * @struct Loader
+ * @brief Kolejka zadań i wątki robocze.
+ */
+struct Loader {
+    struct AssetJob jobs[LOADER_MAX];           ///< Zadania w kolejności priorytetu.
+    int count;                                  ///< Liczba zadań.
+    int next;                                   ///< Następne zadanie dla wątku roboczego.
+    int remaining;                              ///< Zadania, które nie są jeszcze ASSET_DONE.
+    ALLEGRO_MUTEX* mutex;                       ///< Ochrona stanów zadań.
+    ALLEGRO_COND* decoded;                      ///< Sygnał zdekodowania zadania.
+    ALLEGRO_THREAD* threads[LOADER_THREADS];    ///< Wątki robocze.
+    int thread_count;                           ///< Liczba wątków roboczych.
+    void* font_data;                            ///< Zawartość pliku czcionki lub NULL.
+    size_t font_size;                           ///< Rozmiar pliku czcionki.
+};
+
+/**
+ * @brief Moduł wczytywania zasobów.
+ */
+struct Loader loader;
+
+/**
+ * @brief Dodaje zadanie wczytywania (przed loader_start), pomijając powtórzone zasoby.
+ *
+ * @param id Zasób.
+ * @param kind Rodzaj zasobu.
+ * @param group Grupa (scena), na którą można czekać, lub -1.
+ */
+void loader_add(enum AssetId id, enum AssetKind kind, int group)
+{
+    for (int i = 0; i < loader.count; i++)
+        if (loader.jobs[i].id == id)
+            return;
+    if (loader.count == LOADER_MAX)
+        return;
+    struct AssetJob* job = &loader.jobs[loader.count++];
+    memset(job, 0, sizeof(*job));
+    job->id = id;
+    job->kind = kind;
+    job->group = group;
+    job->state = ASSET_PENDING;
+}
+
+/**
+ * @brief Wczytuje cały plik do pamięci (przez interfejs plików Allegro, więc także z archiwum).
+ */
+static void* loader_read_file(const char* path, size_t* size)
+{
+    ALLEGRO_FILE* file = al_fopen(path, "rb");
+    if (!file)
+        return NULL;
+    int64_t length = al_fsize(file);
+    void* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (data && al_fread(file, data, (size_t)length) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    al_fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+/**
+ * @brief Dekoduje jeden zasób (w wątku roboczym albo, bez wątków, w wątku okna).
+ */
+static void loader_decode(struct AssetJob* job)
+{
+    char sized[256];
+    const char* path = job->kind == ASSET_IMAGE ? asset_sized_path(job->id, textures.width, sized, sizeof(sized)) : asset_path(job->id);
+    if (job->kind == ASSET_IMAGE)
+        job->bitmap = al_load_bitmap(path);
+    else if (job->kind == ASSET_MUSIC)
+        job->stream = al_load_audio_stream(path, SONG_BUFFERS, SONG_BUFFER_SAMPLES);
+    else
+        job->data = loader_read_file(path, &job->size);
+}
+
+/**
+ * @brief Wątek roboczy: pobiera kolejne zadania i dekoduje je.
+ */
+static void* loader_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    (void)arg;
+    // Flagi nowych bitmap i interfejs plików są ustawieniami wątku: ten wątek nie ma okna
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    assets_use_thread();
+    for (;;) {
+        al_lock_mutex(loader.mutex);
+        if (loader.next == loader.count) {
+            al_unlock_mutex(loader.mutex);
+            return NULL;
+        }
+        struct AssetJob* job = &loader.jobs[loader.next++];
+        job->state = ASSET_DECODING;
+        al_unlock_mutex(loader.mutex);
+
+        loader_decode(job);
+
+        al_lock_mutex(loader.mutex);
+        job->state = ASSET_DECODED;
+        al_broadcast_cond(loader.decoded);
+        al_unlock_mutex(loader.mutex);
+    }
+}
+
+/**
+ * @brief Uruchamia wątki robocze dla dodanych zadań.
+ *
+ * Jeśli nie udało się utworzyć żadnego wątku, zasoby są dekodowane od razu w wątku okna.
+ */
+void loader_start(void)
+{
+    loader.next = 0;
+    loader.remaining = loader.count;
+    loader.mutex = al_create_mutex();
+    loader.decoded = al_create_cond();
+    int threads = al_get_cpu_count() - 1;
+    threads = threads < 1 ? 1 : threads > LOADER_THREADS ? LOADER_THREADS : threads;
+    loader.thread_count = 0;
+    for (int i = 0; i < threads; i++) {
+        ALLEGRO_THREAD* thread = al_create_thread(loader_worker, NULL);
+        if (thread) {
+            al_start_thread(thread);
+            loader.threads[loader.thread_count++] = thread;
+        }
+    }
+
+    // Bez wątków roboczych nikt nie zdekodowałby zadań, a loader_wait czekałby w nieskończoność
+    if (loader.thread_count == 0) {
+        fprintf(stderr, "No loader threads; loading assets synchronously\n");
+        for (; loader.next < loader.count; loader.next++) {
+            loader_decode(&loader.jobs[loader.next]);
+            loader.jobs[loader.next].state = ASSET_DECODED;
+        }
+    }
+}
+
+/**
+ * @brief Przekazuje zdekodowany zasób dalej (wątek okna).
+ */
+static void loader_finish(struct AssetJob* job)
+{
+    if (job->kind == ASSET_IMAGE) {
+        if (!job->bitmap) {
+            fprintf(stderr, "Failed to load image: %s\n", asset_path(job->id));
+            exit(-3);
+        }
+        // Przeniesienie do pamięci karty graficznej wg flag wątku okna
+        al_convert_bitmap(job->bitmap);
+        if (!texture_loaded(job->id))
+            texture_add(job->id, job->bitmap);
+        else
+            al_destroy_bitmap(job->bitmap);     // Wczytana już synchronicznie
+        job->bitmap = NULL;
+    }
+    else if (job->kind == ASSET_MUSIC) {
+        if (!job->stream) {
+            fprintf(stderr, "Nie udało się załadować utworu: %s\n", asset_path(job->id));
+            exit(-5);
+        }
+        play_song(job->stream);
+        job->stream = NULL;
+    }
+    else {
+        loader.font_data = job->data;
+        loader.font_size = job->size;
+        job->data = NULL;
+    }
+}
+
+/**
+ * @brief Przekazuje dalej wszystkie zdekodowane zasoby; nie czeka.
+ *
+ * @return Liczba zadań, które nie są jeszcze zakończone.
+ */
+int loader_poll(void)
+{
+    if (!loader.mutex || loader.remaining == 0)
+        return 0;
+    for (int i = 0; i < loader.count; i++) {
+        al_lock_mutex(loader.mutex);
+        bool ready = loader.jobs[i].state == ASSET_DECODED;
+        al_unlock_mutex(loader.mutex);
+        if (ready) {
+            loader_finish(&loader.jobs[i]);
+            loader.jobs[i].state = ASSET_DONE;
+            loader.remaining--;
+        }
+    }
+    return loader.remaining;
+}
+
+/**
+ * @brief Czeka, aż wszystkie zasoby grupy zostaną wczytane.
+ *
+ * @param group Grupa (scena).
+ */
+void loader_wait(int group)
+{
+    if (!loader.mutex)
+        return;
+    // Bez wątków roboczych wszystko zostało zdekodowane w loader_start
+    if (loader.thread_count == 0) {
+        loader_poll();
+        return;
+    }
+    for (;;) {
+        loader_poll();
+        bool done = true;
+        al_lock_mutex(loader.mutex);
+        for (int i = 0; i < loader.count; i++) {
+            if (loader.jobs[i].group != group || loader.jobs[i].state == ASSET_DONE)
+                continue;
+            done = false;
+            if (loader.jobs[i].state != ASSET_DECODED)
+                al_wait_cond(loader.decoded, loader.mutex);
+            break;
+        }
+        al_unlock_mutex(loader.mutex);
+        if (done)
+            return;
+    }
+}
+
+/**
+ * @brief Sprawdza, czy zasób czeka jeszcze na wątek roboczy lub okna.
+ *
+ * @param id Zasób.
+ * @return true, jeśli zasób jest w trakcie wczytywania.
+ */
+bool loader_pending(enum AssetId id)
+{
+    if (!loader.mutex || loader.remaining == 0)
+        return false;
+    for (int i = 0; i < loader.count; i++)
+        if (loader.jobs[i].state != ASSET_DONE && loader.jobs[i].id == id)
+            return true;
+    return false;
+}
+
+/**
+ * @brief Czeka na wątki robocze i zwalnia niewykorzystane zasoby.
+ */
+void loader_stop(void)
+{
+    if (!loader.mutex)
+        return;
+    for (int i = 0; i < loader.thread_count; i++) {
+        al_join_thread(loader.threads[i], NULL);
+        al_destroy_thread(loader.threads[i]);
+    }
+    for (int i = 0; i < loader.count; i++) {
+        struct AssetJob* job = &loader.jobs[i];
+        if (job->bitmap)
+            al_destroy_bitmap(job->bitmap);
+        if (job->stream)
+            al_destroy_audio_stream(job->stream);
+        free(job->data);
+    }
+    al_destroy_cond(loader.decoded);
+    al_destroy_mutex(loader.mutex);
+    loader.mutex = NULL;
+}
+
+#endif
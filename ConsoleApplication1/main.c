@@ -1,8 +1,17 @@
 ﻿#define _CRT_SECURE_NO_WARNINGS
-#include "menu.h"
+#include "app.h"
 #include "define.h"
 #include "sound.h"
+#include "batch.h"
+#include "generator.h"
+#include "bank.h"
+#include "canon.h"
+#include "assetpack.h"
+#include "transcode.h"
 #include <allegro5/allegro5.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 /**
  * \mainpage Sudoku
@@ -37,6 +46,27 @@
 
 
 
+/**
+ * @brief Podłącza wyjście trybu wsadowego do konsoli, z której uruchomiono program.
+ *
+ * Program jest linkowany jako /SUBSYSTEM:windows, więc nie dostaje własnej konsoli,
+ * a bez tego raporty wypisywane przez printf/fprintf nigdzie się nie pojawiają.
+ * Przekierowane wyjście (np. do pliku) pozostaje bez zmian.
+ */
+static void attach_console(void)
+{
+#ifdef _WIN32
+    // Strumienie przekierowane przez wywołującego mają prawidłowy uchwyt już przed podłączeniem
+    bool out = GetFileType(GetStdHandle(STD_OUTPUT_HANDLE)) == FILE_TYPE_UNKNOWN;
+    bool err = GetFileType(GetStdHandle(STD_ERROR_HANDLE)) == FILE_TYPE_UNKNOWN;
+    if (!AttachConsole(ATTACH_PARENT_PROCESS))
+        return;
+    if (out)
+        freopen("CONOUT$", "w", stdout);
+    if (err)
+        freopen("CONOUT$", "w", stderr);
+#endif
+}
 
 /**
  * @brief Główna funkcja programu.
@@ -45,12 +75,36 @@
  * ustawia kolejkę zdarzeń, inicjalizuje dźwięk i wyświetla menu. Obsługuje również
  * czyszczenie zasobów i zamykanie dodatków po zakończeniu programu.
  *
+ * Uruchomiony z argumentem --solve, --generate, --pack, --dedup, --transcode lub --pack-assets
+ * działa w trybie wsadowym (bez okna) – patrz batch.h, generator.h, bank.h, canon.h,
+ * transcode.h i assetpack.h.
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
  * @return int Zwraca 0 po pomyślnym zakończeniu.
  */
-int main(void) {
+int main(int argc, char** argv) {
     #pragma comment(linker, "/SUBSYSTEM:windows /ENTRY:mainCRTStartup")
     // Inicjalizacja dodatków Allegro
     al_init();
+    app_start_time = al_get_time();
+
+    // Tryby wsadowe bez interfejsu graficznego (raporty trafiają do konsoli wywołującej)
+    if (argc > 1 && strncmp(argv[1], "--", 2) == 0)
+        attach_console();
+    if (argc > 1 && strcmp(argv[1], "--solve") == 0)
+        return batch_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0)
+        return generator_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--pack") == 0)
+        return bank_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--dedup") == 0)
+        return dedup_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--transcode") == 0)
+        return transcode_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--pack-assets") == 0)
+        return assetpack_main(argc, argv);
+
     al_install_mouse(); // Instalacja dodatku do obsługi myszy
     al_init_font_addon(); // Inicjalizacja dodatku do obsługi czcionek
     al_init_ttf_addon(); // Inicjalizacja dodatku do obsługi czcionek TrueType
@@ -58,14 +112,23 @@ int main(void) {
     al_init_primitives_addon(); // Inicjalizacja dodatku do obsługi prymitywów
     al_init_acodec_addon(); // Inicjalizacja dodatku do obsługi kodeków audio
     al_install_audio(); // Instalacja dodatku do obsługi dźwięku
+    al_init_native_dialog_addon(); // Inicjalizacja dodatku do obsługi okien dialogowych
+
+    // Zasoby z archiwum assets.zip (luźne pliki jako nadpisanie) przez PhysFS
+    assets_mount(argv[0]);
 
-    // Tworzenie okna wyświetlania
+    // Tworzenie okna wyświetlania (z powiadomieniem o odsłonięciu, potrzebnym w trybie tła)
+    al_set_new_display_flags(ALLEGRO_GENERATE_EXPOSE_EVENTS);
     ALLEGRO_DISPLAY* display = al_create_display(W, H);
     if (!display) exit(-1);
 
     // Ustawienie tytułu okna
     al_set_window_title(display, "Sudoku");
 
+    // Układ ekranów dla początkowego rozmiaru okna
+    layout_compute(&layout, W, H);
+    textures.width = layout.width;      // Tekstury przeskalowane dla tej szerokości okna
+
     // Utworzenie kolejki zdarzeń do obsługi zdarzeń
     ALLEGRO_EVENT_QUEUE* event_queue = al_create_event_queue();
 
@@ -73,23 +136,27 @@ int main(void) {
     al_register_event_source(event_queue, al_get_mouse_event_source()); // Rejestracja zdarzeń myszy
     al_register_event_source(event_queue, al_get_display_event_source(display)); // Rejestracja zdarzeń wyświetlania
 
-    // Inicjalizacja dźwięku
+    // Inicjalizacja dźwięku (pierwszy utwór wczytuje loader.h)
     init_sound();
 
-    // Odtwarzanie muzyki w tle
-    al_play_sample_instance(songInstance);
+    // Mapowanie banku plansz (bez pliku plansze są generowane na bieżąco)
+    open_bank(&puzzle_bank, BANK_FILE);
 
-    // Wyświetlenie menu
-    menu(display, event_queue);
+    // Główna pętla: menu, gra i ustawienia jako sceny jednego stosu
+    app_run(display, event_queue);
+    close_bank(&puzzle_bank);
+
+    // Zwolnienie tekstur wspólnych dla wszystkich ekranów
+    textures_destroy();
 
     // Zatrzymanie odtwarzania muzyki i zwolnienie zasobów
-    if (songInstance) {
-        al_destroy_sample_instance(songInstance);
-    }
-    if (song) {
-        al_destroy_sample(song);
+    if (songStream) {
+        al_destroy_audio_stream(songStream);
     }
 
+    // Odmontowanie archiwum zasobów
+    assets_unmount();
+
     // Wyłączanie dodatków, zwalnianie zasobów
     al_shutdown_primitives_addon(); // Wyłączenie dodatku do obsługi prymitywów
     al_shutdown_image_addon(); // Wyłączenie dodatku do obsługi obrazów
@@ -97,6 +164,7 @@ int main(void) {
     al_shutdown_font_addon(); // Wyłączenie dodatku do obsługi czcionek
     al_uninstall_mouse(); // Wyłączenie dodatku do obsługi myszy
     al_uninstall_audio(); // Wyłączenie dodatku do obsługi dźwięku
+    al_shutdown_native_dialog_addon(); // Wyłączenie dodatku do obsługi okien dialogowych
 
     // Zniszczenie kolejki zdarzeń i okna wyświetlania
     al_destroy_event_queue(event_queue);
@@ -0,0 +1,126 @@
+/**
+ * @file mapfile.h
+ * @brief Mapowanie plików do pamięci (tylko do odczytu).
+ *
+ * Na Windows używa CreateFileMapping/MapViewOfFile, na pozostałych systemach mmap.
+ * Zmapowany plik jest czytany bezpośrednio z pamięci podręcznej systemu, bez kopiowania
+ * do własnych buforów.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef MAPFILE
+#define MAPFILE
+
+/**
+ * @struct MappedFile
+ * @brief Plik zmapowany do pamięci.
+ */
+struct MappedFile {
+    const char* data;   ///< Początek zmapowanego obszaru.
+    size_t size;        ///< Rozmiar pliku w bajtach.
+#ifdef _WIN32
+    HANDLE file;        ///< Uchwyt pliku.
+    HANDLE mapping;     ///< Uchwyt mapowania.
+#endif
+};
+
+/**
+ * @brief Mapuje plik do pamięci tylko do odczytu.
+ *
+ * @param path Ścieżka do pliku.
+ * @param mf Struktura, do której zostanie zapisane mapowanie.
+ * @return true, jeśli mapowanie powiodło się, w przeciwnym razie false.
+ */
+bool map_file(const char* path, struct MappedFile* mf)
+{
+    mf->data = NULL;
+    mf->size = 0;
+#ifdef _WIN32
+    mf->mapping = NULL;
+    mf->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mf->file == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "Unable to open %s.\n", path);
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mf->file, &size)) {
+        CloseHandle(mf->file);
+        return false;
+    }
+    mf->size = (size_t)size.QuadPart;
+    if (mf->size == 0)
+        return true;
+    mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mf->mapping == NULL) {
+        CloseHandle(mf->file);
+        return false;
+    }
+    mf->data = (const char*)MapViewOfFile(mf->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (mf->data == NULL) {
+        CloseHandle(mf->mapping);
+        CloseHandle(mf->file);
+        return false;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open %s.\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    mf->size = (size_t)st.st_size;
+    if (mf->size > 0) {
+        void* data = mmap(NULL, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, mf->size, MADV_SEQUENTIAL);
+        mf->data = (const char*)data;
+    }
+    close(fd);
+#endif
+    return true;
+}
+
+/**
+ * @brief Zwalnia mapowanie pliku.
+ *
+ * @param mf Zmapowany plik.
+ */
+void unmap_file(struct MappedFile* mf)
+{
+#ifdef _WIN32
+    if (mf->data)
+        UnmapViewOfFile(mf->data);
+    if (mf->mapping)
+        CloseHandle(mf->mapping);
+    if (mf->file != INVALID_HANDLE_VALUE)
+        CloseHandle(mf->file);
+    mf->mapping = NULL;
+    mf->file = INVALID_HANDLE_VALUE;
+#else
+    if (mf->data)
+        munmap((void*)mf->data, mf->size);
+#endif
+    mf->data = NULL;
+    mf->size = 0;
+}
+
+#endif
@@ -17,47 +17,103 @@
 #include "define.h"
 #include "game.h"
 #include "sound.h"
-
-#define SAVE_FILE "save.dat"
+#include "saves.h"
+#include "stats.h"
+#include "puzzleio.h"
+#include "layout.h"
+#include "widget.h"
+#include "scene.h"
 
 #include <allegro5/allegro5.h>
 #include <allegro5/allegro_font.h>
 #include <allegro5/allegro_ttf.h>
 #include <allegro5/allegro_image.h>
+#include <allegro5/allegro_native_dialog.h>
 
 #ifndef MENU
 #define MENU
 
+/**
+ * @brief Ekrany menu, każdy z własnym zestawem widocznych widżetów.
+ */
+enum MenuScreen {
+    SCREEN_MAIN,            ///< Menu główne.
+    SCREEN_DIFFICULT,       ///< Wybór poziomu trudności.
+    SCREEN_SLOTS,           ///< Lista slotów zapisu.
+    SCREEN_STATS,           ///< Statystyki.
+    MENU_SCREENS            ///< Liczba ekranów.
+};
+
+/**
+ * @brief Tworzy widżety menu w kolejności enum MenuButton.
+ *
+ * @param widgets Widżety menu.
+ */
+void createMenuWidgets(struct Widgets* widgets)
+{
+    widgets_clear(widgets);
+    widget_image(widgets, ASSET_START);
+    widget_image(widgets, ASSET_CONTINUE);
+    widget_text(widgets, "Stats");
+    widget_text(widgets, "Import");
+    widget_image(widgets, ASSET_EASY);
+    widget_image(widgets, ASSET_MID);
+    widget_image(widgets, ASSET_HARD);
+    widget_image(widgets, ASSET_LEFT_ARROW);
+    // Wiersze slotów rysuje displaySlots, widżety są tylko obszarami klikalnymi
+    for (int i = 0; i < SAVE_SLOTS; i++)
+        widget_area(widgets);
+}
+
+/**
+ * @brief Ustawia widoczność widżetów menu dla ekranu.
+ *
+ * @param widgets Widżety menu.
+ * @param screen Ekran menu.
+ * @param continue_flag Flaga wskazująca, czy przycisk kontynuacji powinien być widoczny.
+ * @param index Indeks slotów zapisu (dla ekranu SCREEN_SLOTS) lub NULL.
+ */
+void showMenuScreen(struct Widgets* widgets, enum MenuScreen screen, bool continue_flag, const struct SaveIndex* index)
+{
+    for (int id = 0; id < MENU_COUNT; id++) {
+        bool visible;
+        if (id >= MENU_SLOT)
+            visible = screen == SCREEN_SLOTS && index->slots[id - MENU_SLOT].used;
+        else if (id == MENU_CONTINUE)
+            visible = screen == SCREEN_MAIN && continue_flag;
+        else if (id == MENU_BACK)
+            visible = screen == SCREEN_SLOTS || screen == SCREEN_STATS;
+        else if (id >= MENU_EASY)
+            visible = screen == SCREEN_DIFFICULT;
+        else
+            visible = screen == SCREEN_MAIN;
+        widget_set(widgets, id, WIDGET_VISIBLE, visible);
+    }
+}
+
 /**
  * @brief Wyświetla menu główne gry.
  *
- * Rysuje tło, przyciski start i kontynuacji oraz nazwę gry.
+ * Rysuje tło, nazwę gry oraz przyciski start, kontynuacji, statystyk i importu.
  *
- * @param background Wskaźnik do bitmapy tła.
- * @param b_start Struktura przycisku start.
- * @param b_continue Struktura przycisku kontynuacji.
- * @param continue_flag Flaga wskazująca, czy przycisk kontynuacji powinien być wyświetlony.
+ * @param background Uchwyt tekstury tła.
+ * @param widgets Widżety menu (widoczność ustawia showMenuScreen).
  * @param font Wskaźnik do czcionki.
  * @param text_width Szerokość tekstu nazwy gry.
  * @param text Tekst nazwy gry.
+ * @param fontSlots Wskaźnik do czcionki przycisków tekstowych.
+ * @param L Układ ekranu rysowanej klatki.
  */
-void displayMenu(ALLEGRO_BITMAP* background, struct OBJECT b_start, struct OBJECT b_continue, bool continue_flag, ALLEGRO_FONT* font, int text_width, char *text)
+void displayMenu(int background, const struct Widgets* widgets, ALLEGRO_FONT* font, int text_width, const char *text, ALLEGRO_FONT* fontSlots, const struct Layout* L)
 {
     // Rysowanie tła
-    al_draw_scaled_bitmap(background, 0, 0, al_get_bitmap_width(background), al_get_bitmap_height(background), 0, 0, W, H, 0);
-
-    // Wyświetlanie przycisku start
-    b_start.show(b_start.name_file, b_start.width, b_start.height, b_start.x, b_start.y);
+    texture_draw(background, 0, 0, L->width, L->height);
 
     // Rysowanie tekstu nazwy gry
-    al_draw_text(font, al_map_rgb(0, 0, 0), (W - text_width) / 2, H / 4, 0, text);
+    al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - text_width) / 2, L->height / 4, 0, text);
 
-    // Wyświetlanie przycisku kontynuacji, jeśli continue_flag jest prawdziwe
-    if (continue_flag)
-    {
-        b_continue.show(b_continue.name_file, b_continue.width, b_continue.height, b_continue.x, b_continue.y);
-    }
-    al_flip_display();
+    // Przyciski ekranu głównego; kontynuacja tylko, jeśli istnieje zapis
+    widgets_draw(widgets, fontSlots);
 }
 
 /**
@@ -65,229 +121,401 @@ void displayMenu(ALLEGRO_BITMAP* background, struct OBJECT b_start, struct OBJEC
  *
  * Rysuje tło, tekst nazwy gry oraz przyciski poziomów trudności.
  *
- * @param background Wskaźnik do bitmapy tła.
+ * @param background Uchwyt tekstury tła.
  * @param font Wskaźnik do czcionki.
  * @param text_width Szerokość tekstu nazwy gry.
  * @param text Tekst nazwy gry.
- * @param b_easy Struktura przycisku łatwego poziomu.
- * @param b_mid Struktura przycisku średniego poziomu.
- * @param b_hard Struktura przycisku trudnego poziomu.
+ * @param widgets Widżety menu.
+ * @param L Układ ekranu rysowanej klatki.
  */
-void displayDiffucult(ALLEGRO_BITMAP* background, ALLEGRO_FONT* font, int text_width, char* text, struct OBJECT b_easy, struct OBJECT b_mid, struct OBJECT b_hard)
+void displayDiffucult(int background, ALLEGRO_FONT* font, int text_width, const char* text, const struct Widgets* widgets, const struct Layout* L)
 {
     // Rysowanie tła
-    al_draw_scaled_bitmap(background, 0, 0, al_get_bitmap_width(background), al_get_bitmap_height(background), 0, 0, W, H, 0);
+    texture_draw(background, 0, 0, L->width, L->height);
     
     // Rysowanie tekstu nazwy gry
-    al_draw_text(font, al_map_rgb(0, 0, 0), (W - text_width) / 2, H / 4, 0, text);
+    al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - text_width) / 2, L->height / 4, 0, text);
 
     // Poziomy trudności
-    b_easy.show(b_easy.name_file, b_easy.width, b_easy.height, b_easy.x, b_easy.y);
-    b_mid.show(b_mid.name_file, b_mid.width, b_mid.height, b_mid.x, b_mid.y);
-    b_hard.show(b_hard.name_file, b_hard.width, b_hard.height, b_hard.x, b_hard.y);
-
-    al_flip_display();
+    widgets_draw(widgets, font);
 }
 
 /**
  * @brief Sprawdza, czy istnieje zapis gry.
  *
- * Ustawia flagę continue_flag na true, jeśli istnieje zapis gry.
+ * Wczytuje tylko plik indeksu slotów (bez otwierania pełnych zapisów)
+ * i ustawia flagę continue_flag na true, jeśli którykolwiek slot jest zajęty.
  *
+ * @param index Struktura, do której zostanie wczytany indeks slotów.
  * @param continue_flag Wskaźnik na flagę kontynuacji.
  */
-void checkEmptyFile(bool *continue_flag)
+void checkSaveIndex(struct SaveIndex* index, bool *continue_flag)
 {
-    FILE* fp = fopen("save.dat", "r");
-    if (fp != NULL) // Jeśli plik nie jest pusty
-    {
-        fseek(fp, 0, SEEK_END); // Przesunięcie wskaźnika pliku na koniec
-        int fsize = ftell(fp);  // Pobranie aktualnej pozycji wskaźnika (rozmiar pliku)
-        if (fsize > 0)  // Sprawdzenie rozmiaru pliku
-            *continue_flag = true;
-        fclose(fp);
-    }
-    else
-        *continue_flag = false;
+    load_index(index);
+    *continue_flag = any_slot_used(index);
 }
 
 /**
- * @brief Aktualizuje układ i rozmiar przycisków na podstawie rozmiaru ekranu.
+ * @brief Wyświetla listę slotów zapisu.
  *
- * @param b_start Wskaźnik na strukturę przycisku start.
- * @param b_continue Wskaźnik na strukturę przycisku kontynuacji.
- * @param b_easy Wskaźnik na strukturę przycisku łatwego poziomu.
- * @param b_mid Wskaźnik na strukturę przycisku średniego poziomu.
- * @param b_hard Wskaźnik na strukturę przycisku trudnego poziomu.
+ * Rysuje tło, nazwę gry, przycisk powrotu oraz po jednym wierszu na slot
+ * z danymi z pliku indeksu (poziom trudności, czas gry, wypełnienie, data ostatniej gry).
+ *
+ * @param background Uchwyt tekstury tła.
+ * @param font Wskaźnik do czcionki nazwy gry.
+ * @param fontSlots Wskaźnik do czcionki wierszy slotów.
+ * @param text_width Szerokość tekstu nazwy gry.
+ * @param text Tekst nazwy gry.
+ * @param index Wczytany indeks slotów.
+ * @param overwrite Czy lista służy do wyboru slotu do nadpisania (wszystkie sloty zajęte).
+ * @param widgets Widżety menu.
+ * @param L Układ ekranu rysowanej klatki.
  */
-void resizing(struct OBJECT *b_start, struct OBJECT *b_continue, struct OBJECT *b_easy, struct OBJECT *b_mid, struct OBJECT* b_hard) {
-    b_start->x = W / 2 - b_start->width / 2;
-    b_start->y = H / 1.25 - b_start->height / 2 - 50;
-
-    b_continue->x = b_start->x;
-    b_continue->y = b_start->y + W / 9;
-
-    b_easy->x = W / 2 - b_easy->width / 2;
-    b_easy->y = H / 1.25 - b_easy->height / 2 - 100;
-
-    b_mid->x = W / 2 - b_mid->width / 2;
-    b_mid->y = b_easy->y + W / 9;
+void displaySlots(int background, ALLEGRO_FONT* font, ALLEGRO_FONT* fontSlots, int text_width, const char* text, const struct SaveIndex* index, bool overwrite, const struct Widgets* widgets, const struct Layout* L)
+{
+    // Rysowanie tła
+    texture_draw(background, 0, 0, L->width, L->height);
 
-    b_hard->x = W / 2 - b_hard->width / 2;
-    b_hard->y = b_mid->y + W / 9;
+    // Rysowanie tekstu nazwy gry
+    al_draw_text(font, al_map_rgb(0, 0, 0), (L->width - text_width) / 2, L->height / 8, 0, text);
+
+    // Wszystkie sloty zajęte – nowa gra czeka na wybór slotu do nadpisania
+    if (overwrite)
+        al_draw_text(fontSlots, al_map_rgb(0, 0, 0), L->width / 2, L->height / 8 + al_get_font_line_height(font), ALLEGRO_ALIGN_CENTRE,
+            "All slots are full - choose one to overwrite");
+
+    // Przycisk powrotu i obszary klikalne zajętych slotów
+    widgets_draw(widgets, fontSlots);
+
+    char line[100];
+    char date[20];
+    for (int i = 0; i < SAVE_SLOTS; i++) {
+        const struct SlotInfo* info = &index->slots[i];
+        struct Rect row = L->menu[MENU_SLOT + i];
+        if (info->used) {
+            time_t last = (time_t)info->last_played;
+            strftime(date, sizeof(date), "%d.%m %H:%M", localtime(&last));
+            snprintf(line, sizeof(line), "%d. %s  %02u:%02u  %d/81  %s", i + 1, difficult_names[difficult_level(info->difficult)],
+                info->time_ms / 60000, info->time_ms / 1000 % 60, info->filled, date);
+            al_draw_rectangle(row.x, row.y, row.x + row.width, row.y + row.height, al_map_rgb(0, 0, 0), 2.0);
+        }
+        else {
+            snprintf(line, sizeof(line), "%d. ---", i + 1);
+        }
+        al_draw_text(fontSlots, al_map_rgb(0, 0, 0), row.x + 10, row.y + (row.height - al_get_font_line_height(fontSlots)) / 2, 0, line);
+    }
+}
 
-    b_start->width = b_continue->width = b_easy->width = b_mid->width = b_hard->width = W / 5;
+/**
+ * @brief Wyświetla ekran statystyk.
+ *
+ * Dane pochodzą wyłącznie z pliku agregatów, wczytywanego przy przejściu do ekranu,
+ * więc ekran wczytuje się natychmiast niezależnie od liczby zapisanych gier.
+ *
+ * @param background Uchwyt tekstury tła.
+ * @param font Wskaźnik do czcionki nazwy gry.
+ * @param fontSlots Wskaźnik do czcionki wierszy statystyk.
+ * @param widgets Widżety menu.
+ * @param stats Wczytane statystyki.
+ * @param L Układ ekranu rysowanej klatki.
+ */
+void displayStats(int background, ALLEGRO_FONT* font, ALLEGRO_FONT* fontSlots, const struct Widgets* widgets, const struct Stats* stats, const struct Layout* L)
+{
 
-    b_start->height = b_continue->height = b_easy->height = b_mid->height = b_hard->height = H / 11;
+    // Rysowanie tła
+    texture_draw(background, 0, 0, L->width, L->height);
+    al_draw_text(font, al_map_rgb(0, 0, 0), L->width / 2, L->height / 8, ALLEGRO_ALIGN_CENTRE, "Stats");
+
+    widgets_draw(widgets, fontSlots);
+
+    char line[100];
+    int line_height = al_get_font_line_height(fontSlots);
+    int y = L->height / 3;
+    for (int i = 0; i < DIFFICULT_LEVELS; i++) {
+        const struct LevelStats* level = &stats->level[i];
+        if (level->games == 0)
+            continue;
+        unsigned int mean = level->wins ? (unsigned int)(level->sum_time / level->wins) : 0;
+        unsigned int median = stats_percentile(level, 50);
+        unsigned int p90 = stats_percentile(level, 90);
+
+        snprintf(line, sizeof(line), "%s: %u games, %u wins", difficult_names[i], level->games, level->wins);
+        al_draw_text(fontSlots, al_map_rgb(0, 0, 0), L->width / 10, y, 0, line);
+        y += line_height;
+        snprintf(line, sizeof(line), "best %02u:%02u  mean %02u:%02u  p50 %02u:%02u  p90 %02u:%02u",
+            level->best_time / 60, level->best_time % 60, mean / 60, mean % 60,
+            median / 60, median % 60, p90 / 60, p90 % 60);
+        al_draw_text(fontSlots, al_map_rgb(0, 0, 0), L->width / 10, y, 0, line);
+        y += line_height * 3 / 2;
+    }
 }
 
 /**
- * @brief Funkcja menu gry.
+ * @brief Importuje planszę z pliku tekstowego wybranego w oknie dialogowym.
  *
- * Wyświetla interfejs menu gry, obsługuje zdarzenia użytkownika i uruchamia grę.
+ * Plik może zawierać wiele plansz (format 81 znaków na linię lub format SDK);
+ * wybierana jest losowa z tych, które nadają się do gry (board_playable – grupy pozycji
+ * i jedno rozwiązanie). Gdy żadna się nie nadaje, wyświetlany jest komunikat błędu.
  *
  * @param display Wskaźnik na wyświetlacz.
- * @param event_queue Wskaźnik na kolejkę zdarzeń.
- * @return 0 jeśli gra zakończyła się pomyślnie.
+ * @param grid Tablica, do której zostanie zapisana plansza.
+ * @return true, jeśli plansza została wczytana.
  */
-int menu(ALLEGRO_DISPLAY* display, ALLEGRO_EVENT_QUEUE* event_queue)
+bool importPuzzle(ALLEGRO_DISPLAY* display, int grid[9][9])
 {
-    ALLEGRO_EVENT event;
-
-    // Ładowanie czcionki
-    ALLEGRO_FONT* font = al_load_ttf_font("Tenada.ttf", SIZE_FONT, 0);
-    if (!font) exit(-2);
+    ALLEGRO_FILECHOOSER* chooser = al_create_native_file_dialog(NULL, "Import puzzle", "*.txt;*.sdm;*.sdk;*.*", ALLEGRO_FILECHOOSER_FILE_MUST_EXIST);
+    if (!chooser)
+        return false;
+
+    bool ok = false;
+    if (al_show_native_file_dialog(display, chooser) && al_get_native_file_dialog_count(chooser) > 0) {
+        ok = import_random_puzzle(al_get_native_file_dialog_path(chooser, 0), grid, board_playable);
+        if (!ok)
+            al_show_native_message_box(display, "Import puzzle", "No playable puzzle in this file",
+                "Every puzzle breaks the rules of this game (rows, columns, boxes and position groups) or has no unique solution.",
+                NULL, ALLEGRO_MESSAGEBOX_ERROR);
+    }
+    al_destroy_native_file_dialog(chooser);
+    return ok;
+}
 
-    // Ładowanie obrazu tła
-    ALLEGRO_BITMAP* background = al_load_bitmap("image/menu_bg.png");
-    if (!background) exit(-3);
+/**
+ * @brief Ustawia położenie i rozmiar widżetów menu z tabeli układu.
+ *
+ * @param widgets Widżety menu.
+ */
+void resizing(struct Widgets* widgets)
+{
+    for (int id = 0; id < MENU_COUNT; id++)
+        widget_place(widgets, id, layout.menu[id]);
+}
 
-    // Definiowanie przycisku start
-    struct OBJECT b_start = (struct OBJECT){ "image/start.png", W / 5, H / 11, 0, 0, show };
-    b_start.x = W / 2 - b_start.width / 2;
-    b_start.y = H / 1.25 - b_start.height / 2 - 50;
+/**
+ * @struct MenuScene
+ * @brief Stan sceny menu, zachowywany przez cały czas działania programu.
+ */
+struct MenuScene {
+    struct Widgets widgets;         ///< Widżety w kolejności enum MenuButton.
+    int background;                 ///< Uchwyt tekstury tła.
+    enum MenuScreen screen;         ///< Aktualny ekran menu.
+    bool continue_flag;             ///< Flaga dla przycisku "Kontynuuj".
+    struct SaveIndex index;         ///< Indeks slotów zapisu.
+    bool overwrite;                 ///< Lista slotów wybiera slot do nadpisania dla nowej gry.
+    bool pending_import;            ///< Czy nowa gra czekająca na slot jest zaimportowaną planszą.
+    int pending_board[9][9];        ///< Zaimportowana plansza nowej gry czekającej na slot.
+    struct Stats stats;             ///< Statystyki (wczytywane przy przejściu do ekranu statystyk).
+};
 
-    // Definiowanie przycisku kontynuacji
-    struct OBJECT b_continue = (struct OBJECT){ "image/continue.png", W / 5, H / 11, 0, 0, show };
-    b_continue.x = b_start.x;
-    b_continue.y = b_start.y + 80;
+/**
+ * @brief Scena menu.
+ */
+struct MenuScene menu_scene;
 
-    // Przyciski poziomu trudności
-    struct OBJECT b_easy = (struct OBJECT){ "image/easy.png", W / 5, H / 11, 0, 0, show };
-    b_easy.x = W / 2 - b_easy.width / 2;
-    b_easy.y = H / 1.25 - b_easy.height / 2 - 100;
+/**
+ * @brief Otwiera menu gry (pierwszą scenę programu).
+ */
+void menu_enter(void)
+{
+    struct MenuScene* M = &menu_scene;
+
+    // Widżety menu; położenie i rozmiar pochodzą z tabeli układu
+    createMenuWidgets(&M->widgets);
+    resizing(&M->widgets);
+    M->background = texture_handle(ASSET_MENU_BG);
+
+    checkSaveIndex(&M->index, &M->continue_flag); // Sprawdzenie, czy istnieje zapis gry do kontynuacji
+    M->screen = SCREEN_MAIN;
+    M->overwrite = false;
+    showMenuScreen(&M->widgets, M->screen, M->continue_flag, &M->index);
+    scene_push(SCENE_MENU);
+}
 
-    struct OBJECT b_mid = (struct OBJECT){ "image/mid.png", W / 5, H / 11, 0, 0, show };
-    b_mid.x = W / 2 - b_mid.width / 2;
-    b_mid.y = b_easy.y + 80;
+/**
+ * @brief Powrót do menu głównego po zakończeniu gry.
+ */
+void menu_resume(void)
+{
+    struct MenuScene* M = &menu_scene;
+    resizing(&M->widgets);
+    checkSaveIndex(&M->index, &M->continue_flag); // Sprawdzenie, czy istnieje zapis
+    M->screen = SCREEN_MAIN;
+    M->overwrite = false;
+    showMenuScreen(&M->widgets, M->screen, M->continue_flag, &M->index);
+}
 
-    struct OBJECT b_hard = (struct OBJECT){ "image/hard.png", W / 5, H / 11, 0, 0, show };
-    b_hard.x = W / 2 - b_hard.width / 2;
-    b_hard.y = b_mid.y + 80;
+/**
+ * @brief Rysuje aktualny ekran menu.
+ *
+ * Wywoływana przez wątek rysowania (render.h) dla migawki stanu menu.
+ *
+ * @param M Stan menu z migawki.
+ * @param L Układ ekranu z migawki.
+ */
+void menu_draw(const struct MenuScene* M, const struct Layout* L)
+{
+    ALLEGRO_FONT* font = scene_font(FONT_TITLE, L);
+    ALLEGRO_FONT* fontSlots = scene_font(FONT_SLOTS, L);
 
     char text[] = "Sudoku"; // Tekst wyświetlany na ekranie (nazwa gry)
     int text_width = al_get_text_width(font, text);
 
-    bool finish = false;    // Flaga końca gry
+    switch (M->screen) {
+    case SCREEN_MAIN: displayMenu(M->background, &M->widgets, font, text_width, text, fontSlots, L); break;
+    case SCREEN_DIFFICULT: displayDiffucult(M->background, font, text_width, text, &M->widgets, L); break;
+    case SCREEN_SLOTS: displaySlots(M->background, font, fontSlots, text_width, text, &M->index, M->overwrite, &M->widgets, L); break;
+    default: displayStats(M->background, font, fontSlots, &M->widgets, &M->stats, L); break;
+    }
+}
 
-    static bool continue_flag = false;      // Flaga dla przycisku "Kontynuuj"
-    checkEmptyFile(&continue_flag);         // Sprawdzenie, czy istnieje zapis gry do kontynuacji
-    bool start_game = false;                // Flaga rozpoczęcia gry
-    
-    bool displayDifficult = false;          // Flaga wyświetlania przycisków poziomu trudności
-    bool chosenDifficult = false;           // Flaga sygnalizująca wybór poziomu trudności
+/**
+ * @brief Rozpoczyna nową grę w pustym slocie.
+ *
+ * Gdy wszystkie sloty są zajęte, gra nie nadpisuje żadnego z nich sama: menu przechodzi
+ * do listy slotów, a gracz wybiera (i potwierdza) slot do nadpisania.
+ *
+ * @param M Stan menu.
+ * @param board Zaimportowana plansza lub NULL, jeśli plansza ma zostać wygenerowana.
+ */
+static void menu_start_game(struct MenuScene* M, const int (*board)[9])
+{
+    int slot = find_free_slot(&M->index);
+    if (slot >= 0) {
+        game_enter(false, slot, board);
+        return;
+    }
+    M->overwrite = true;
+    M->pending_import = board != NULL;
+    if (board != NULL)
+        memcpy(M->pending_board, board, sizeof(M->pending_board));
+    M->screen = SCREEN_SLOTS;
+}
 
-    displayMenu(background, b_start, b_continue, continue_flag, font, text_width, text);        // Wyświetlanie interfejsu menu
-    
-    while (!finish)
-    {
-        al_wait_for_event(event_queue, &event);
+/**
+ * @brief Obsługuje kliknięcie w menu i uruchamia grę.
+ *
+ * @param event Zdarzenie.
+ */
+static void menu_click(const ALLEGRO_EVENT* event)
+{
+    struct MenuScene* M = &menu_scene;
+
+    // Zdarzenie kliknięcia przyciskiem myszy
+    if (event->type != ALLEGRO_EVENT_MOUSE_BUTTON_DOWN || !(event->mouse.button & 1))
+        return;
+
+    // Widżet pod kursorem; widoczne są tylko widżety aktualnego ekranu
+    int hit = widgets_hit(&M->widgets, event->mouse.x, event->mouse.y);
+
+    if (M->screen == SCREEN_STATS) {
+        // Sprawdzenie, czy przycisk powrotu został kliknięty
+        if (hit == MENU_BACK)
+            M->screen = SCREEN_MAIN;
+    }
+    else if (M->screen == SCREEN_SLOTS) {
+        // Sprawdzenie, czy przycisk powrotu został kliknięty
+        if (hit == MENU_BACK)
+        {
+            M->screen = SCREEN_MAIN;
+            M->overwrite = false;
+            return;
+        }
 
-        // Zdarzenie zamknięcia
-        if (event.type == ALLEGRO_EVENT_DISPLAY_CLOSE) {
-            finish = true;
+        int i = hit - MENU_SLOT;
+        if (i < 0 || i >= SAVE_SLOTS || !M->index.slots[i].used)
+            return;
+
+        // Nowa gra w miejsce wybranego zapisu – dopiero po potwierdzeniu
+        if (M->overwrite) {
+            char question[64];
+            snprintf(question, sizeof(question), "Overwrite the game saved in slot %d?", i + 1);
+            if (al_show_native_message_box(scenes.display, "Save slots", question, "The saved game will be lost.",
+                NULL, ALLEGRO_MESSAGEBOX_YES_NO | ALLEGRO_MESSAGEBOX_WARN) != 1)
+                return;
+            M->overwrite = false;
+            delete_slot(i);
+            game_enter(false, i, M->pending_import ? M->pending_board : NULL);
+            return;
+        }
+
+        // Sprawdzenie, czy wybrano zajęty slot – dopiero teraz wczytywany jest pełny zapis
+        if (!game_enter(true, i, NULL))
+            al_show_native_message_box(scenes.display, "Continue", "Unable to load this saved game",
+                "The save file is missing or corrupt.", NULL, ALLEGRO_MESSAGEBOX_ERROR);
+    }
+    else if (M->screen == SCREEN_MAIN) {
+        // Sprawdzenie, czy przycisk statystyk został kliknięty
+        if (hit == MENU_STATS)
+        {
+            load_stats(&M->stats);
+            M->screen = SCREEN_STATS;
+            return;
         }
 
-        // Zdarzenie kliknięcia przyciskiem myszy
-        if (event.type == ALLEGRO_EVENT_MOUSE_BUTTON_DOWN)
+        // Sprawdzenie, czy przycisk importu został kliknięty
+        if (hit == MENU_IMPORT)
         {
-            if (event.mouse.button & 1)
-            {
-                int x = event.mouse.x;
-                int y = event.mouse.y;
-
-                if (!displayDifficult) {
-                    // Sprawdzenie, czy przycisk start został kliknięty
-                    if (x >= b_start.x && x < (b_start.x + b_start.width) && y >= b_start.y && y < (b_start.y + b_start.height))
-                    {
-                        continue_flag = true;
-                        displayDiffucult(background, font, text_width, text, b_easy, b_mid, b_hard);
-                        displayDifficult = true;
-                    }
-
-                    if (continue_flag)
-                    {
-                        // Sprawdzenie, czy przycisk kontynuacji został kliknięty
-                        if (x >= b_continue.x && x < (b_continue.x + b_continue.width) && y >= b_continue.y && y < (b_continue.y + b_continue.height))
-                        {
-                            bool exit_game = game(display, event_queue, true);
-                            if (exit_game) {
-                                finish = true;
-                            }
-                            else
-                            {
-                                checkEmptyFile(&continue_flag);
-                                displayMenu(background, b_start, b_continue, continue_flag, font, text_width, text);
-                            }
-                        }
-                    }
-                }
-                else {
-                    // Sprawdzenie, czy wybrano poziom trudności
-                    if (x >= b_easy.x && x < (b_easy.x + b_easy.width) && y >= b_easy.y && y < (b_easy.y + b_easy.height))
-                    {
-                        difficult[0] = 3; // Szansa
-                        difficult[1] = 4; // Liczba pustych komórek
-                        
-                        chosenDifficult = true; // Ustawienie flagi sygnalizującej wybór poziomu trudności
-                    }
-
-                    if (x >= b_mid.x && x < (b_mid.x + b_mid.width) && y >= b_mid.y && y < (b_mid.y + b_mid.height))
-                    {
-                        difficult[0] = 3;  
-                        difficult[1] = 5;
-                        chosenDifficult = true; // Ustawienie flagi sygnalizującej wybór poziomu trudności
-                    }
-
-                    if (x >= b_hard.x && x < (b_hard.x + b_hard.width) && y >= b_hard.y && y < (b_hard.y + b_hard.height))
-                    {
-                        difficult[0] = 4;  
-                        difficult[1] = 6;
-                        chosenDifficult = true; // Ustawienie flagi sygnalizującej wybór poziomu trudności
-                    }
-
-                    if (chosenDifficult) {
-                        bool exit_game = game(display, event_queue, false); // Rozpoczęcie gry z wybranym poziomem trudności
-                        // Jeśli gra zostanie zamknięta
-                        if (exit_game) {
-                            finish = true;
-                        }
-                        else {
-                            // Powrót do menu
-                            resizing(&b_start, &b_continue, &b_easy, &b_mid, &b_hard);
-                            checkEmptyFile(&continue_flag); // Sprawdzenie, czy istnieje zapis
-                            displayMenu(background, b_start, b_continue, continue_flag, font, text_width, text);
-                            displayDifficult = false; // Resetowanie flagi wyświetlania poziomów trudności
-                            chosenDifficult = false; // Resetowanie flagi wybranego poziomu trudności
-                        }
-                    }
-                }
+            int imported[9][9];
+            if (importPuzzle(scenes.display, imported)) {
+                difficult[0] = 0;   // Plansza z pliku nie ma poziomu trudności generatora
+                difficult[1] = 0;
+                menu_start_game(M, imported);
             }
+            return;
+        }
+
+        // Sprawdzenie, czy przycisk start został kliknięty
+        if (hit == MENU_START)
+        {
+            M->continue_flag = true;
+            M->screen = SCREEN_DIFFICULT;
+        }
+
+        // Sprawdzenie, czy przycisk kontynuacji został kliknięty
+        else if (M->continue_flag && hit == MENU_CONTINUE)
+        {
+            M->screen = SCREEN_SLOTS;
+        }
+    }
+    else {
+        // Sprawdzenie, czy wybrano poziom trudności
+        bool chosenDifficult = true;
+        if (hit == MENU_EASY)
+        {
+            difficult[0] = 3; // Szansa
+            difficult[1] = 4; // Liczba pustych komórek
+        }
+        else if (hit == MENU_MID)
+        {
+            difficult[0] = 3;
+            difficult[1] = 5;
         }
+        else if (hit == MENU_HARD)
+        {
+            difficult[0] = 4;
+            difficult[1] = 6;
+        }
+        else
+            chosenDifficult = false;
+
+        // Rozpoczęcie gry z wybranym poziomem trudności w wolnym slocie
+        if (chosenDifficult)
+            menu_start_game(M, NULL);
     }
-    al_destroy_font(font);
-    al_destroy_bitmap(background);
-    return 0;
+}
+
+/**
+ * @brief Obsługuje zdarzenie w menu.
+ *
+ * Po zdarzeniu widoczność widżetów odpowiada aktualnemu ekranowi, więc migawka
+ * przekazana do wątku rysowania jest od razu kompletna.
+ *
+ * @param event Zdarzenie.
+ */
+void menu_event(const ALLEGRO_EVENT* event)
+{
+    struct MenuScene* M = &menu_scene;
+    menu_click(event);
+    showMenuScreen(&M->widgets, M->screen, M->continue_flag, &M->index);
 }
 
 #endif
@@ -0,0 +1,167 @@
+/**
+ * @file notes.h
+ * @brief Notatki (kandydaci zapisani ołówkiem) w pustych komórkach planszy.
+ *
+ * Każda komórka ma 9-bitową maskę notatek. Wpisanie cyfry usuwa ją z notatek wszystkich
+ * komórek zależnych (wiersz, kolumna, kwadrat 3x3, grupa pozycji), a "wypełnij wszystko"
+ * wylicza notatki z masek jednostek planszy w jednym przejściu.
+ *
+ * Małe cyfry (do 729 na klatkę) rysowane są z jednej bitmapy-atlasu z dziewięcioma
+ * cyframi, z wstrzymanym rysowaniem (al_hold_bitmap_drawing), dzięki czemu Allegro
+ * wysyła je jako jedną partię. Atlas należy do wątku rysowania (render.h), a notatki
+ * do stanu gry.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_image.h>
+
+#include "solver.h"
+#include "board.h"
+#include "texture.h"
+
+#ifndef NOTES
+#define NOTES
+
+/**
+ * @struct Notes
+ * @brief Notatki planszy.
+ */
+struct Notes {
+    unsigned short mask[81];    ///< Notatki każdej komórki (bit d-1 – cyfra d).
+};
+
+/**
+ * @struct NotesAtlas
+ * @brief Atlas małych cyfr.
+ */
+struct NotesAtlas {
+    ALLEGRO_BITMAP* bitmap;     ///< Atlas małych cyfr 1-9 w jednym wierszu.
+    int glyph;                  ///< Rozmiar jednej cyfry w atlasie (piksele).
+};
+
+/**
+ * @brief Usuwa wszystkie notatki.
+ *
+ * @param notes Notatki.
+ */
+void notes_clear(struct Notes* notes)
+{
+    memset(notes->mask, 0, sizeof(notes->mask));
+}
+
+/**
+ * @brief Przełącza notatkę cyfry w komórce.
+ *
+ * @param notes Notatki.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Cyfra 1-9.
+ */
+void notes_toggle(struct Notes* notes, int row, int column, int digit)
+{
+    notes->mask[row * 9 + column] ^= (unsigned short)(1u << (digit - 1));
+}
+
+/**
+ * @brief Usuwa notatki komórki, do której wpisano cyfrę, i tę cyfrę z notatek komórek zależnych.
+ *
+ * @param notes Notatki.
+ * @param row Wiersz komórki.
+ * @param column Kolumna komórki.
+ * @param digit Wpisana cyfra 1-9.
+ */
+void notes_prune(struct Notes* notes, int row, int column, int digit)
+{
+    unsigned short bit = (unsigned short)~(1u << (digit - 1));
+    int box = box_of(row, column), pos = pos_of(row, column);
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++)
+            if (i == row || j == column || box_of(i, j) == box || pos_of(i, j) == pos)
+                notes->mask[i * 9 + j] &= bit;
+    notes->mask[row * 9 + column] = 0;
+}
+
+/**
+ * @brief Wypełnia notatki wszystkich pustych komórek kandydatami wynikającymi z masek jednostek.
+ *
+ * @param notes Notatki.
+ * @param grid Plansza.
+ * @param masks Maski jednostek planszy.
+ */
+void notes_fill(struct Notes* notes, const int grid[9][9], const struct BoardMasks* masks)
+{
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++)
+            notes->mask[i * 9 + j] = grid[i][j] ? 0 : (unsigned short)(~(masks->row[i] | masks->col[j]
+                | masks->box[box_of(i, j)] | masks->pos[pos_of(i, j)]) & ALL_DIGITS);
+}
+
+/**
+ * @brief Zwalnia atlas małych cyfr.
+ *
+ * @param atlas Atlas.
+ */
+void notes_destroy_atlas(struct NotesAtlas* atlas)
+{
+    if (atlas->bitmap)
+        al_destroy_bitmap(atlas->bitmap);
+    atlas->bitmap = NULL;
+}
+
+/**
+ * @brief Tworzy atlas małych cyfr o zadanym rozmiarze z tekstur image/numbers/N.png.
+ *
+ * @param atlas Atlas.
+ * @param glyph Rozmiar jednej cyfry w pikselach.
+ * @return true, jeśli atlas został utworzony.
+ */
+bool notes_create_atlas(struct NotesAtlas* atlas, int glyph)
+{
+    notes_destroy_atlas(atlas);
+    atlas->glyph = glyph;
+    atlas->bitmap = al_create_bitmap(9 * glyph, glyph);
+    if (!atlas->bitmap)
+        return false;
+
+    ALLEGRO_BITMAP* target = al_get_target_bitmap();
+    al_set_target_bitmap(atlas->bitmap);
+    al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+    for (int d = 0; d < 9; d++)
+        texture_draw(texture_get(asset_digits[d]), d * glyph, 0, glyph, glyph);
+    al_set_target_bitmap(target);
+    return true;
+}
+
+/**
+ * @brief Rysuje notatki pustych komórek jedną partią z atlasu.
+ *
+ * @param notes Notatki.
+ * @param atlas Atlas małych cyfr.
+ * @param grid Plansza (notatki są rysowane tylko w pustych komórkach).
+ * @param cell_width Szerokość komórki siatki.
+ * @param cell_height Wysokość komórki siatki.
+ */
+void notes_draw(const struct Notes* notes, const struct NotesAtlas* atlas, const int grid[9][9], float cell_width, float cell_height)
+{
+    if (!atlas->bitmap)
+        return;
+    al_hold_bitmap_drawing(true);
+    for (int cell = 0; cell < 81; cell++) {
+        unsigned int mask = notes->mask[cell];
+        if (!mask || grid[cell / 9][cell % 9])
+            continue;
+        float x = (cell % 9) * cell_width, y = (cell / 9) * cell_height;
+        for (int d = 0; d < 9; d++)
+            if (mask & (1u << d))
+                al_draw_bitmap_region(atlas->bitmap, d * atlas->glyph, 0, atlas->glyph, atlas->glyph,
+                    x + (d % 3) * cell_width / 3 + (cell_width / 3 - atlas->glyph) / 2,
+                    y + (d / 3) * cell_height / 3 + (cell_height / 3 - atlas->glyph) / 2, 0);
+    }
+    al_hold_bitmap_drawing(false);
+}
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file puzzleio.h
+ * @brief Strumieniowy odczyt i zapis zbiorów plansz Sudoku w formatach tekstowych.
+ *
+ * Obsługiwane formaty:
+ * - jedna plansza na linię (81 znaków, puste komórki jako '.' lub '0'),
+ * - format SDK: 9 linii po 9 znaków, opcjonalnie z separatorami '|', '-', '+' i spacjami.
+ *
+ * Czytnik działa na pliku zmapowanym do pamięci i nie alokuje pamięci na linię:
+ * każda plansza jest dekodowana bezpośrednio z bufora do tablicy int[9][9].
+ * Plik jest czytany linia po linii: linie, które nie są planszą ani wierszem planszy SDK
+ * (komentarze, nagłówki), są pomijane, a błędna linia nie przesuwa kolejnych plansz.
+ * Po 81 komórkach linii może stać odstęp i np. ocena trudności.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mapfile.h"
+
+#ifndef PUZZLEIO
+#define PUZZLEIO
+
+/**
+ * @struct PuzzleReader
+ * @brief Kursor czytnika plansz na zmapowanym pliku.
+ */
+struct PuzzleReader {
+    struct MappedFile file;     ///< Zmapowany plik.
+    const char* cur;            ///< Bieżąca pozycja.
+    const char* end;            ///< Koniec danych.
+    long long line;             ///< Numer bieżącej linii (do komunikatów o błędach).
+};
+
+/**
+ * @brief Otwiera plik z planszami.
+ *
+ * @param reader Czytnik do zainicjalizowania.
+ * @param path Ścieżka do pliku.
+ * @return true, jeśli plik został otwarty, w przeciwnym razie false.
+ */
+bool open_puzzles(struct PuzzleReader* reader, const char* path)
+{
+    if (!map_file(path, &reader->file))
+        return false;
+    reader->cur = reader->file.data;
+    reader->end = reader->file.data + reader->file.size;
+    reader->line = 1;
+    return true;
+}
+
+/**
+ * @brief Zamyka plik z planszami.
+ *
+ * @param reader Czytnik do zamknięcia.
+ */
+void close_puzzles(struct PuzzleReader* reader)
+{
+    unmap_file(&reader->file);
+    reader->cur = reader->end = NULL;
+}
+
+/**
+ * @brief Sprawdza, czy znak jest komórką planszy ('1'-'9', '.', '0').
+ */
+static bool is_cell_char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+/**
+ * @brief Sprawdza, czy znak jest separatorem formatu SDK lub odstępem.
+ */
+static bool is_separator_char(char c)
+{
+    return c == '|' || c == '-' || c == '+' || c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Wczytuje następną planszę z pliku.
+ *
+ * Plik jest czytany linia po linii. Plansza to linia z dokładnie 81 komórkami
+ * (po pierwszych 81 znakach może stać odstęp i np. ocena) albo 9 kolejnych linii
+ * formatu SDK z dokładnie 9 komórkami każda; linie z samych separatorów ("---+---")
+ * wewnątrz planszy SDK są pomijane. Każda inna linia jest pomijana (komentarze,
+ * nagłówki typu "Grid 01", puste linie), a linia z samymi komórkami w innej liczbie
+ * jest zgłaszana jako błędna. Niepełna plansza SDK jest zgłaszana i odrzucana, a czytanie
+ * wznawia się od następnej linii, więc błąd nie przesuwa kolejnych plansz.
+ *
+ * @param reader Czytnik plansz.
+ * @param grid Tablica, do której zostanie zapisana plansza (0 oznacza pustą komórkę).
+ * @return true, jeśli wczytano planszę; false na końcu pliku.
+ */
+bool read_puzzle(struct PuzzleReader* reader, int grid[9][9])
+{
+    int rows = 0;               // Wczytane wiersze planszy SDK
+    long long first = 0;        // Linia pierwszego wiersza planszy SDK
+
+    while (reader->cur < reader->end) {
+        const char* line = reader->cur;
+        const char* next = memchr(line, '\n', reader->end - line);
+        const char* end = next ? next : reader->end;
+        if (end > line && end[-1] == '\r')
+            end--;
+        long long number = reader->line;
+        reader->cur = next ? next + 1 : reader->end;
+        reader->line++;
+
+        // Komórki linii (najwyżej 81) i to, czy linia zawiera coś poza komórkami i separatorami
+        int cells[81];
+        int count = 0;
+        int run = 0;
+        bool other = false, separators = false;
+        for (const char* p = line; p < end; p++) {
+            if (is_cell_char(*p)) {
+                if (count < 81)
+                    cells[count] = *p == '.' ? 0 : *p - '0';
+                count++;
+                if (run == p - line)
+                    run++;
+            }
+            else if (is_separator_char(*p))
+                separators |= *p != ' ' && *p != '\t';
+            else if (run != 81 || p == line + 81)
+                other = true;   // Po 81 komórkach i odstępie może stać np. ocena
+        }
+        // 81 komórek na początku linii, po nich koniec linii lub odstęp
+        bool line81 = run == 81 && (line + 81 == end || line[81] == ' ' || line[81] == '\t' || line[81] == ';');
+        if (line81 || (!other && count == 81)) {
+            if (rows > 0)
+                fprintf(stderr, "Incomplete puzzle at line %lld skipped.\n", first);
+            for (int i = 0; i < 81; i++)
+                grid[i / 9][i % 9] = cells[i];
+            return true;
+        }
+        if (!other && count == 9) {
+            if (rows == 0)
+                first = number;
+            memcpy(grid[rows], cells, sizeof(grid[rows]));
+            if (++rows == 9)
+                return true;
+            continue;
+        }
+        if (!other && count == 0 && separators)
+            continue;   // Linia separatorów formatu SDK
+
+        // Każda inna linia kończy rozpoczętą planszę SDK
+        if (rows > 0) {
+            fprintf(stderr, "Incomplete puzzle at line %lld skipped.\n", first);
+            rows = 0;
+        }
+        if (!other && count > 0)
+            fprintf(stderr, "Malformed puzzle line %lld (%d cells) skipped.\n", number, count);
+    }
+    if (rows > 0)
+        fprintf(stderr, "Incomplete puzzle at line %lld skipped.\n", first);
+    return false;
+}
+
+/**
+ * @brief Zapisuje planszę jako jedną linię 81 znaków.
+ *
+ * @param file Plik wyjściowy.
+ * @param grid Plansza do zapisania.
+ * @param blank Znak pustej komórki ('.' lub '0').
+ * @return true, jeśli zapis powiódł się.
+ */
+bool write_puzzle_line(FILE* file, const int grid[9][9], char blank)
+{
+    char line[82];
+    for (int i = 0; i < 81; i++) {
+        int v = grid[i / 9][i % 9];
+        line[i] = v ? (char)('0' + v) : blank;
+    }
+    line[81] = '\n';
+    return fwrite(line, 1, sizeof(line), file) == sizeof(line);
+}
+
+/**
+ * @brief Zapisuje planszę w formacie SDK (9 linii po 9 znaków, pusta linia po planszy).
+ *
+ * @param file Plik wyjściowy.
+ * @param grid Plansza do zapisania.
+ * @return true, jeśli zapis powiódł się.
+ */
+bool write_puzzle_sdk(FILE* file, const int grid[9][9])
+{
+    char text[9 * 10 + 1];
+    char* p = text;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++)
+            *p++ = grid[i][j] ? (char)('0' + grid[i][j]) : '.';
+        *p++ = '\n';
+    }
+    *p++ = '\n';
+    return fwrite(text, 1, sizeof(text), file) == sizeof(text);
+}
+
+/**
+ * @brief Wybiera losową planszę z pliku w jednym przebiegu (reservoir sampling).
+ *
+ * @param path Ścieżka do pliku z planszami.
+ * @param grid Tablica, do której zostanie zapisana wybrana plansza.
+ * @param accept Funkcja odrzucająca plansze (false – plansza nie bierze udziału w losowaniu) lub NULL.
+ * @return true, jeśli w pliku była co najmniej jedna przyjęta plansza.
+ */
+bool import_random_puzzle(const char* path, int grid[9][9], bool (*accept)(const int grid[9][9]))
+{
+    struct PuzzleReader reader;
+    if (!open_puzzles(&reader, path))
+        return false;
+
+    int temp[9][9];
+    long long count = 0;
+    while (read_puzzle(&reader, temp)) {
+        if (accept && !accept(temp))
+            continue;
+        count++;
+        long long r = ((long long)rand() << 30) ^ ((long long)rand() << 15) ^ rand();
+        if (r % count == 0)
+            memcpy(grid, temp, sizeof(temp));
+    }
+    close_puzzles(&reader);
+    return count > 0;
+}
+
+#endif
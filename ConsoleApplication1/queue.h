@@ -0,0 +1,175 @@
+/**
+ * @file queue.h
+ * @brief Ograniczona kolejka FIFO elementów stałego rozmiaru do komunikacji między wątkami.
+ *
+ * push() blokuje, gdy kolejka jest pełna, a pop() – gdy jest pusta. Po zamknięciu
+ * kolejki (queue_close) wszystkie oczekujące wątki są budzone: push() zwraca false,
+ * a pop() zwraca false, gdy nie ma już elementów.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <allegro5/allegro5.h>
+
+#ifndef QUEUE
+#define QUEUE
+
+/**
+ * @struct BoundedQueue
+ * @brief Kolejka cykliczna chroniona muteksem i dwiema zmiennymi warunkowymi.
+ */
+struct BoundedQueue {
+    unsigned char* items;       ///< Bufor elementów.
+    size_t item_size;           ///< Rozmiar jednego elementu.
+    int capacity;               ///< Maksymalna liczba elementów.
+    int head;                   ///< Indeks pierwszego elementu.
+    int count;                  ///< Liczba elementów w kolejce.
+    bool closed;                ///< Czy kolejka została zamknięta.
+    ALLEGRO_MUTEX* mutex;       ///< Chroni stan kolejki.
+    ALLEGRO_COND* not_empty;    ///< Sygnalizowana po dodaniu elementu.
+    ALLEGRO_COND* not_full;     ///< Sygnalizowana po pobraniu elementu.
+};
+
+/**
+ * @brief Tworzy kolejkę.
+ *
+ * @param queue Kolejka do zainicjalizowania.
+ * @param item_size Rozmiar elementu w bajtach.
+ * @param capacity Maksymalna liczba elementów.
+ * @return true, jeśli alokacja powiodła się.
+ */
+bool queue_create(struct BoundedQueue* queue, size_t item_size, int capacity)
+{
+    queue->items = malloc(item_size * capacity);
+    queue->item_size = item_size;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = false;
+    queue->mutex = al_create_mutex();
+    queue->not_empty = al_create_cond();
+    queue->not_full = al_create_cond();
+    return queue->items && queue->mutex && queue->not_empty && queue->not_full;
+}
+
+/**
+ * @brief Zwalnia zasoby kolejki.
+ *
+ * @param queue Kolejka do zniszczenia.
+ */
+void queue_destroy(struct BoundedQueue* queue)
+{
+    free(queue->items);
+    queue->items = NULL;
+    al_destroy_cond(queue->not_empty);
+    al_destroy_cond(queue->not_full);
+    al_destroy_mutex(queue->mutex);
+}
+
+/**
+ * @brief Dodaje element na koniec kolejki (blokuje, gdy kolejka jest pełna).
+ *
+ * @param queue Kolejka.
+ * @param item Element do skopiowania.
+ * @return false, jeśli kolejka została zamknięta.
+ */
+bool queue_push(struct BoundedQueue* queue, const void* item)
+{
+    al_lock_mutex(queue->mutex);
+    while (queue->count == queue->capacity && !queue->closed)
+        al_wait_cond(queue->not_full, queue->mutex);
+    if (queue->closed) {
+        al_unlock_mutex(queue->mutex);
+        return false;
+    }
+    int tail = (queue->head + queue->count) % queue->capacity;
+    memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    al_signal_cond(queue->not_empty);
+    al_unlock_mutex(queue->mutex);
+    return true;
+}
+
+/**
+ * @brief Dodaje element bez blokowania.
+ *
+ * @param queue Kolejka.
+ * @param item Element do skopiowania.
+ * @return false, jeśli kolejka jest pełna lub zamknięta.
+ */
+bool queue_try_push(struct BoundedQueue* queue, const void* item)
+{
+    al_lock_mutex(queue->mutex);
+    bool ok = queue->count < queue->capacity && !queue->closed;
+    if (ok) {
+        int tail = (queue->head + queue->count) % queue->capacity;
+        memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+        queue->count++;
+        al_signal_cond(queue->not_empty);
+    }
+    al_unlock_mutex(queue->mutex);
+    return ok;
+}
+
+/**
+ * @brief Pobiera element z początku kolejki (blokuje, gdy kolejka jest pusta).
+ *
+ * @param queue Kolejka.
+ * @param item Bufor na pobrany element.
+ * @return false, jeśli kolejka jest zamknięta i pusta.
+ */
+bool queue_pop(struct BoundedQueue* queue, void* item)
+{
+    al_lock_mutex(queue->mutex);
+    while (queue->count == 0 && !queue->closed)
+        al_wait_cond(queue->not_empty, queue->mutex);
+    if (queue->count == 0) {
+        al_unlock_mutex(queue->mutex);
+        return false;
+    }
+    memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    al_signal_cond(queue->not_full);
+    al_unlock_mutex(queue->mutex);
+    return true;
+}
+
+/**
+ * @brief Pobiera element bez blokowania.
+ *
+ * @param queue Kolejka.
+ * @param item Bufor na pobrany element.
+ * @return true, jeśli pobrano element.
+ */
+bool queue_try_pop(struct BoundedQueue* queue, void* item)
+{
+    al_lock_mutex(queue->mutex);
+    bool ok = queue->count > 0;
+    if (ok) {
+        memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        al_signal_cond(queue->not_full);
+    }
+    al_unlock_mutex(queue->mutex);
+    return ok;
+}
+
+/**
+ * @brief Zamyka kolejkę i budzi wszystkie oczekujące wątki.
+ *
+ * @param queue Kolejka.
+ */
+void queue_close(struct BoundedQueue* queue)
+{
+    al_lock_mutex(queue->mutex);
+    queue->closed = true;
+    al_broadcast_cond(queue->not_empty);
+    al_broadcast_cond(queue->not_full);
+    al_unlock_mutex(queue->mutex);
+}
+
+#endif
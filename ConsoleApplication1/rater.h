@@ -0,0 +1,434 @@
+/**
+ * @file rater.h
+ * @brief Ocena trudności planszy technikami rozwiązywania stosowanymi przez ludzi.
+ *
+ * Plansza jest rozwiązywana logicznie na maskach kandydatów: w każdym kroku stosowana
+ * jest najprostsza technika, która coś wnosi (wpisanie cyfry lub usunięcie kandydatów).
+ * Jednostkami są wiersze, kolumny, kwadraty 3x3 i grupy pozycji (is_poz), więc wszystkie
+ * techniki działają także na grupach pozycji. Trudność planszy to najtrudniejsza technika
+ * potrzebna do jej rozwiązania; plansza, której nie da się rozwiązać bez zgadywania,
+ * dostaje LOGIC_GUESS.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "solver.h"
+
+#ifndef RATER
+#define RATER
+
+/**
+ * @brief Liczba jednostek planszy (9 wierszy, 9 kolumn, 9 kwadratów, 9 grup pozycji).
+ */
+#define LOGIC_UNITS 36
+
+/**
+ * @enum LogicTechnique
+ * @brief Techniki rozwiązywania, od najprostszej do najtrudniejszej.
+ */
+enum LogicTechnique {
+    LOGIC_HIDDEN_SINGLE,        ///< Cyfra ma w jednostce tylko jedno miejsce.
+    LOGIC_NAKED_SINGLE,         ///< Komórka ma tylko jednego kandydata.
+    LOGIC_LOCKED_CANDIDATES,    ///< Cyfra w jednostce leży tylko w przecięciu z inną jednostką.
+    LOGIC_NAKED_PAIR,           ///< Dwie komórki jednostki z tymi samymi dwoma kandydatami.
+    LOGIC_HIDDEN_PAIR,          ///< Dwie cyfry jednostki mieszczą się tylko w dwóch komórkach.
+    LOGIC_NAKED_TRIPLE,         ///< Trzy komórki jednostki z trzema kandydatami łącznie.
+    LOGIC_HIDDEN_TRIPLE,        ///< Trzy cyfry jednostki mieszczą się tylko w trzech komórkach.
+    LOGIC_X_WING,               ///< Cyfra w dwóch wierszach (kolumnach, kwadratach, grupach pozycji) w tych samych dwóch jednostkach poprzecznych.
+    LOGIC_GUESS,                ///< Brak techniki – potrzebne zgadywanie.
+    LOGIC_TECHNIQUES
+};
+
+/**
+ * @brief Nazwy technik.
+ */
+const char* logic_names[LOGIC_TECHNIQUES] = {
+    "Hidden single", "Naked single", "Locked candidates", "Naked pair", "Hidden pair",
+    "Naked triple", "Hidden triple", "X-Wing", "Guess"
+};
+
+/**
+ * @struct Logic
+ * @brief Stan rozwiązywania logicznego.
+ */
+struct Logic {
+    unsigned char grid[81];     ///< Plansza (0 – pusta komórka).
+    unsigned short cand[81];    ///< Kandydaci pustych komórek (0 dla wypełnionych).
+    int empty;                  ///< Liczba pustych komórek.
+};
+
+/**
+ * @struct LogicMove
+ * @brief Wynik jednego kroku rozwiązywania.
+ */
+struct LogicMove {
+    enum LogicTechnique technique;  ///< Zastosowana technika.
+    int cell;                       ///< Komórka, do której wpisano cyfrę, lub -1 przy usuwaniu kandydatów.
+    int digit;                      ///< Wpisana cyfra (0 przy usuwaniu kandydatów).
+};
+
+/**
+ * @brief Zwraca k-tą komórkę jednostki.
+ *
+ * @param unit Jednostka: 0-8 wiersze, 9-17 kolumny, 18-26 kwadraty, 27-35 grupy pozycji.
+ * @param k Numer komórki w jednostce (0-8).
+ * @return Indeks komórki (0-80).
+ */
+static int unit_cell(int unit, int k)
+{
+    int u = unit % 9;
+    switch (unit / 9) {
+    case 0: return u * 9 + k;
+    case 1: return k * 9 + u;
+    case 2: return ((u / 3) * 3 + k / 3) * 9 + (u % 3) * 3 + k % 3;
+    default: return ((k / 3) * 3 + u / 3) * 9 + (k % 3) * 3 + u % 3;
+    }
+}
+
+/**
+ * @brief Wypełnia tablicę czterech jednostek komórki.
+ */
+static void cell_units(int cell, int units[4])
+{
+    int r = cell / 9, c = cell % 9;
+    units[0] = r;
+    units[1] = 9 + c;
+    units[2] = 18 + box_of(r, c);
+    units[3] = 27 + pos_of(r, c);
+}
+
+/**
+ * @brief Wpisuje cyfrę i usuwa ją z kandydatów wszystkich komórek zależnych.
+ *
+ * @param L Stan rozwiązywania.
+ * @param cell Komórka.
+ * @param digit Cyfra 1-9.
+ */
+void logic_place(struct Logic* L, int cell, int digit)
+{
+    unsigned short bit = (unsigned short)(1u << (digit - 1));
+    int units[4];
+    cell_units(cell, units);
+    for (int i = 0; i < 4; i++)
+        for (int k = 0; k < 9; k++)
+            L->cand[unit_cell(units[i], k)] &= (unsigned short)~bit;
+    L->grid[cell] = (unsigned char)digit;
+    L->cand[cell] = 0;
+    L->empty--;
+}
+
+/**
+ * @brief Inicjalizuje stan rozwiązywania planszą.
+ *
+ * @param L Stan rozwiązywania.
+ * @param grid Plansza (0 – pusta komórka).
+ * @return false, jeśli podane cyfry są ze sobą sprzeczne.
+ */
+bool logic_init(struct Logic* L, const int grid[9][9])
+{
+    memset(L->grid, 0, sizeof(L->grid));
+    for (int i = 0; i < 81; i++)
+        L->cand[i] = ALL_DIGITS;
+    L->empty = 81;
+    for (int i = 0; i < 81; i++) {
+        int digit = grid[i / 9][i % 9];
+        if (digit == 0)
+            continue;
+        if (digit < 1 || digit > 9 || !(L->cand[i] & (1u << (digit - 1))))
+            return false;
+        logic_place(L, i, digit);
+    }
+    return true;
+}
+
+/**
+ * @brief Szuka cyfry, która ma w jakiejś jednostce tylko jedno miejsce.
+ */
+static bool logic_hidden_single(struct Logic* L, struct LogicMove* move)
+{
+    for (int u = 0; u < LOGIC_UNITS; u++) {
+        unsigned int once = 0, twice = 0;
+        for (int k = 0; k < 9; k++) {
+            unsigned int m = L->cand[unit_cell(u, k)];
+            twice |= once & m;
+            once |= m;
+        }
+        unsigned int single = once & ~twice;
+        if (!single)
+            continue;
+        single &= ~single + 1;
+        for (int k = 0; k < 9; k++) {
+            int cell = unit_cell(u, k);
+            if (L->cand[cell] & single) {
+                move->cell = cell;
+                move->digit = bit_digit(single);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Szuka komórki z jednym kandydatem.
+ */
+static bool logic_naked_single(struct Logic* L, struct LogicMove* move)
+{
+    for (int cell = 0; cell < 81; cell++) {
+        unsigned int m = L->cand[cell];
+        if (m && !(m & (m - 1))) {
+            move->cell = cell;
+            move->digit = bit_digit(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Usuwa kandydatów ukrytych w przecięciach jednostek.
+ *
+ * Kwadrat lub grupa pozycji przecina wiersz lub kolumnę w trzech komórkach albo wcale.
+ * Jeśli cyfra w jednej z jednostek występuje tylko w przecięciu, znika z reszty drugiej.
+ */
+static bool logic_locked_candidates(struct Logic* L)
+{
+    bool changed = false;
+    for (int a = 18; a < LOGIC_UNITS; a++)
+        for (int b = 0; b < 18; b++) {
+            unsigned int in_a = 0, in_b = 0, inter = 0;
+            int shared = 0;
+            for (int k = 0; k < 9; k++) {
+                int cell = unit_cell(a, k);
+                bool on_b = b < 9 ? cell / 9 == b : cell % 9 == b - 9;
+                if (on_b) {
+                    inter |= L->cand[cell];
+                    shared++;
+                }
+                else {
+                    in_a |= L->cand[cell];
+                }
+            }
+            if (shared == 0)
+                continue;
+            for (int k = 0; k < 9; k++) {
+                int cell = unit_cell(b, k);
+                int units[4];
+                cell_units(cell, units);
+                if (units[a < 27 ? 2 : 3] != a)
+                    in_b |= L->cand[cell];
+            }
+            // Cyfry zamknięte w przecięciu po stronie jednej jednostki
+            unsigned int from_b = inter & ~in_a & in_b;
+            unsigned int from_a = inter & ~in_b & in_a;
+            if (!from_a && !from_b)
+                continue;
+            for (int k = 0; k < 9; k++) {
+                int cell = unit_cell(b, k);
+                int units[4];
+                cell_units(cell, units);
+                if (units[a < 27 ? 2 : 3] != a)
+                    L->cand[cell] &= (unsigned short)~from_b;
+                cell = unit_cell(a, k);
+                if (!(b < 9 ? cell / 9 == b : cell % 9 == b - 9))
+                    L->cand[cell] &= (unsigned short)~from_a;
+            }
+            changed = true;
+        }
+    return changed;
+}
+
+/**
+ * @brief Usuwa kandydatów na podstawie nagich lub ukrytych podzbiorów rozmiaru n.
+ *
+ * @param L Stan rozwiązywania.
+ * @param n Rozmiar podzbioru (2 lub 3).
+ * @param hidden false – nagie podzbiory komórek, true – ukryte podzbiory cyfr.
+ * @return true, jeśli usunięto jakiegoś kandydata.
+ */
+static bool logic_subset(struct Logic* L, int n, bool hidden)
+{
+    for (int u = 0; u < LOGIC_UNITS; u++) {
+        // places[d] – komórki jednostki (bity k), w których może stać cyfra d
+        unsigned int places[9] = { 0 };
+        unsigned int cells = 0;
+        for (int k = 0; k < 9; k++) {
+            unsigned int m = L->cand[unit_cell(u, k)];
+            if (m)
+                cells |= 1u << k;
+            for (int d = 0; d < 9; d++)
+                if (m & (1u << d))
+                    places[d] |= 1u << k;
+        }
+        if (bit_count(cells) <= n)
+            continue;
+
+        for (unsigned int set = 0; set < 512; set++) {
+            if (bit_count(set) != n)
+                continue;
+            bool changed = false;
+            if (!hidden) {
+                // set – komórki jednostki
+                if ((set & cells) != set)
+                    continue;
+                unsigned int digits = 0;
+                for (int k = 0; k < 9; k++)
+                    if (set & (1u << k))
+                        digits |= L->cand[unit_cell(u, k)];
+                if (bit_count(digits) != n)
+                    continue;
+                for (int k = 0; k < 9; k++) {
+                    int cell = unit_cell(u, k);
+                    if (!(set & (1u << k)) && (L->cand[cell] & digits)) {
+                        L->cand[cell] &= (unsigned short)~digits;
+                        changed = true;
+                    }
+                }
+            }
+            else {
+                // set – cyfry
+                unsigned int where = 0;
+                bool present = true;
+                for (int d = 0; d < 9 && present; d++)
+                    if (set & (1u << d)) {
+                        present = places[d] != 0;
+                        where |= places[d];
+                    }
+                if (!present || bit_count(where) != n)
+                    continue;
+                for (int k = 0; k < 9; k++) {
+                    int cell = unit_cell(u, k);
+                    if ((where & (1u << k)) && (L->cand[cell] & ~set)) {
+                        L->cand[cell] &= (unsigned short)set;
+                        changed = true;
+                    }
+                }
+            }
+            if (changed)
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Usuwa kandydatów wzorcem X-Wing.
+ *
+ * Kwadraty i grupy pozycji przecinają się, tak jak wiersze i kolumny, w dokładnie
+ * jednej komórce (k-ta komórka kwadratu leży w grupie pozycji k), więc wzorzec działa
+ * dla obu par rodzin jednostek: wiersze z kolumnami i kwadraty z grupami pozycji.
+ */
+static bool logic_x_wing(struct Logic* L)
+{
+    for (int d = 0; d < 9; d++) {
+        unsigned int bit = 1u << d;
+        for (int family = 0; family < 4; family++) {
+            // places[i] – jednostki poprzeczne z cyfrą w jednostce i rodziny (kolumny dla wierszy, grupy pozycji dla kwadratów itd.)
+            int base = family * 9;
+            unsigned int places[9] = { 0 };
+            for (int i = 0; i < 9; i++)
+                for (int k = 0; k < 9; k++)
+                    if (L->cand[unit_cell(base + i, k)] & bit)
+                        places[i] |= 1u << k;
+            for (int i = 0; i < 9; i++) {
+                if (bit_count(places[i]) != 2)
+                    continue;
+                for (int j = i + 1; j < 9; j++) {
+                    if (places[j] != places[i])
+                        continue;
+                    bool changed = false;
+                    for (int o = 0; o < 9; o++) {
+                        if (o == i || o == j || !(places[o] & places[i]))
+                            continue;
+                        for (int k = 0; k < 9; k++)
+                            if (places[i] & (1u << k))
+                                L->cand[unit_cell(base + o, k)] &= (unsigned short)~bit;
+                        changed = true;
+                    }
+                    if (changed)
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Wykonuje jeden krok rozwiązywania najprostszą skuteczną techniką.
+ *
+ * Techniki pojedyncze wpisują cyfrę (move->cell, move->digit); pozostałe tylko usuwają
+ * kandydatów (move->cell = -1).
+ *
+ * @param L Stan rozwiązywania.
+ * @param move Opis wykonanego kroku.
+ * @return false, jeśli żadna technika nie pomaga (potrzebne zgadywanie) lub plansza jest rozwiązana.
+ */
+bool logic_step(struct Logic* L, struct LogicMove* move)
+{
+    move->cell = -1;
+    move->digit = 0;
+    if (L->empty == 0)
+        return false;
+    if (logic_hidden_single(L, move))
+        move->technique = LOGIC_HIDDEN_SINGLE;
+    else if (logic_naked_single(L, move))
+        move->technique = LOGIC_NAKED_SINGLE;
+    else if (logic_locked_candidates(L))
+        move->technique = LOGIC_LOCKED_CANDIDATES;
+    else if (logic_subset(L, 2, false))
+        move->technique = LOGIC_NAKED_PAIR;
+    else if (logic_subset(L, 2, true))
+        move->technique = LOGIC_HIDDEN_PAIR;
+    else if (logic_subset(L, 3, false))
+        move->technique = LOGIC_NAKED_TRIPLE;
+    else if (logic_subset(L, 3, true))
+        move->technique = LOGIC_HIDDEN_TRIPLE;
+    else if (logic_x_wing(L))
+        move->technique = LOGIC_X_WING;
+    else {
+        move->technique = LOGIC_GUESS;
+        return false;
+    }
+    if (move->cell >= 0)
+        logic_place(L, move->cell, move->digit);
+    return true;
+}
+
+/**
+ * @brief Ocenia planszę: najtrudniejsza technika potrzebna do jej rozwiązania.
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @return Najtrudniejsza użyta technika lub LOGIC_GUESS, jeśli logika nie wystarcza.
+ */
+enum LogicTechnique rate_logic(const int grid[9][9])
+{
+    struct Logic L;
+    if (!logic_init(&L, grid))
+        return LOGIC_GUESS;
+    enum LogicTechnique hardest = LOGIC_HIDDEN_SINGLE;
+    struct LogicMove move;
+    while (logic_step(&L, &move))
+        if (move.technique > hardest)
+            hardest = move.technique;
+    return L.empty == 0 ? hardest : LOGIC_GUESS;
+}
+
+/**
+ * @brief Zamienia technikę na poziom trudności gry.
+ *
+ * @param technique Najtrudniejsza potrzebna technika.
+ * @return 0 – łatwy (tylko pojedyncze), 1 – średni (przecięcia i pary),
+ *         2 – trudny (trójki, X-Wing lub zgadywanie).
+ */
+int logic_level(enum LogicTechnique technique)
+{
+    if (technique <= LOGIC_NAKED_SINGLE)
+        return 0;
+    if (technique <= LOGIC_HIDDEN_PAIR)
+        return 1;
+    return 2;
+}
+
+#endif
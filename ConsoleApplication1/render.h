@@ -0,0 +1,342 @@
+/**
+ * @file render.h
+ * @brief Wątek rysowania zasilany migawkami stanu scen.
+ *
+ * Wątek logiki (app.h) obsługuje wejście i stan gry, a po każdym zdarzeniu publikuje
+ * migawkę: kopię stosu scen, układu ekranu, planszy i stanu scen. Wątek rysowania ma
+ * okno jako cel rysowania, odbiera takty zegara klatek i rysuje zawsze najnowszą
+ * opublikowaną migawkę. Długie rozwiązywanie planszy po kliknięciu nie wstrzymuje
+ * więc klatek (zegar gry liczony jest przy rysowaniu), a wolna klatka nie opóźnia
+ * obsługi kolejnego kliknięcia.
+ *
+ * Migawki krążą w trzech buforach: wątek logiki pisze do swojego, wątek rysowania
+ * czyta ze swojego, a pod muteksem wymieniane są tylko indeksy buforów. Żaden wątek
+ * nie czeka więc na drugi dłużej niż trwa wymiana dwóch liczb, a rysowana migawka
+ * nie zmienia się w trakcie klatki.
+ *
+ * Wszystko, co dotyka karty graficznej – przeniesienie zdekodowanych obrazów, tekstury,
+ * czcionki, atlas notatek, zmiana rozmiaru okna – robi wątek rysowania. Przełącza on
+ * też utwory po zakończeniu poprzedniego i ustawia głośność z migawki. Wątek logiki
+ * steruje nim poleceniami (zdarzenia użytkownika RENDER_EVENT).
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_audio.h>
+
+#include "scene.h"
+#include "menu.h"
+#include "game.h"
+#include "setting.h"
+#include "sound.h"
+#include "loader.h"
+#include "notes.h"
+#include "functions.h"
+
+#ifndef RENDER
+#define RENDER
+
+/**
+ * @brief Typ zdarzeń z poleceniami dla wątku rysowania ("SDKR").
+ */
+#define RENDER_EVENT ALLEGRO_GET_EVENT_TYPE('S', 'D', 'K', 'R')
+
+/**
+ * @brief Polecenia dla wątku rysowania (pole user.data1 zdarzenia RENDER_EVENT).
+ */
+enum RenderCommand {
+    RENDER_REDRAW,          ///< Narysuj klatkę poza taktem zegara (np. odsłonięte okno).
+    RENDER_FOREGROUND,      ///< Okno wróciło na pierwszy plan.
+    RENDER_BACKGROUND,      ///< Okno przeszło w tło.
+    RENDER_HALT,            ///< System wstrzymał rysowanie (potwierdzane przez wątek rysowania).
+    RENDER_RESUME,          ///< System wznowił rysowanie.
+    RENDER_STOP             ///< Zakończ wątek.
+};
+
+/**
+ * @brief Czas startu programu (al_get_time) lub 0 po wypisaniu czasu pierwszej klatki.
+ */
+double app_start_time;
+
+/**
+ * @struct RenderFrame
+ * @brief Migawka stanu potrzebnego do narysowania klatki.
+ */
+struct RenderFrame {
+    enum SceneId stack[SCENE_COUNT];    ///< Sceny od dołu do szczytu.
+    int count;                          ///< Liczba scen na stosie.
+    struct Layout layout;               ///< Układ ekranu.
+    struct MenuScene menu;              ///< Stan menu.
+    struct GameScene game;              ///< Stan gry.
+    int grid[9][9];                     ///< Plansza gry.
+    struct SettingScene setting;        ///< Stan ustawień.
+    double volume;                      ///< Głośność muzyki.
+};
+
+/**
+ * @struct Render
+ * @brief Wątek rysowania, jego kolejka i bufory migawek.
+ */
+struct Render {
+    struct RenderFrame frames[3];       ///< Bufory migawek.
+    int back;                           ///< Bufor zapisywany przez wątek logiki.
+    int ready;                          ///< Ostatnia opublikowana migawka.
+    int front;                          ///< Bufor rysowany przez wątek rysowania.
+    bool fresh;                         ///< Czy ready jest nowsza niż front.
+    ALLEGRO_MUTEX* mutex;               ///< Ochrona indeksów buforów.
+
+    ALLEGRO_THREAD* thread;             ///< Wątek rysowania.
+    ALLEGRO_EVENT_QUEUE* queue;         ///< Kolejka wątku rysowania (takty klatek i polecenia).
+    ALLEGRO_EVENT_SOURCE commands;      ///< Źródło poleceń wątku logiki.
+    ALLEGRO_DISPLAY* display;           ///< Okno.
+    int bitmap_flags;                   ///< Flagi nowych bitmap wątku logiki sprzed render_start.
+
+    struct NotesAtlas atlas;            ///< Atlas małych cyfr notatek.
+    int width;                          ///< Szerokość okna ustawiona przez wątek rysowania.
+    int height;                         ///< Wysokość okna ustawiona przez wątek rysowania.
+    ALLEGRO_AUDIO_STREAM* song;         ///< Utwór, któremu ustawiono głośność.
+    double volume;                      ///< Ustawiona głośność.
+    int top;                            ///< Scena na szczycie stosu w ostatniej klatce lub -1.
+    bool background;                    ///< Okno jest w tle.
+    bool halted;                        ///< System wstrzymał rysowanie.
+
+    long long frames_drawn;             ///< Narysowane klatki.
+    long long dropped_ticks;            ///< Pominięte zaległe takty zegara klatek.
+    long long wakeups[2];               ///< Zdarzenia odebrane z kolejki (aktywne okno, tło).
+};
+
+/**
+ * @brief Wątek rysowania programu.
+ */
+struct Render render;
+
+/**
+ * @brief Publikuje migawkę aktualnego stanu scen (wątek logiki).
+ */
+void render_publish(void)
+{
+    struct RenderFrame* F = &render.frames[render.back];
+    memcpy(F->stack, scenes.stack, sizeof(F->stack));
+    F->count = scenes.count;
+    F->layout = layout;
+    F->menu = menu_scene;
+    F->game = game_scene;
+    memcpy(F->grid, matrix_area, sizeof(F->grid));
+    F->setting = setting_scene;
+    F->volume = volume;
+
+    // Zapisany bufor staje się gotowy, a poprzedni gotowy – buforem do zapisu
+    al_lock_mutex(render.mutex);
+    int ready = render.ready;
+    render.ready = render.back;
+    render.back = ready;
+    render.fresh = true;
+    al_unlock_mutex(render.mutex);
+}
+
+/**
+ * @brief Wysyła polecenie do wątku rysowania.
+ *
+ * @param command Polecenie.
+ */
+void render_command(enum RenderCommand command)
+{
+    ALLEGRO_EVENT event;
+    memset(&event, 0, sizeof(event));
+    event.user.type = RENDER_EVENT;
+    event.user.data1 = command;
+    al_emit_user_event(&render.commands, &event, NULL);
+}
+
+/**
+ * @brief Zwraca najnowszą migawkę (wątek rysowania).
+ */
+static const struct RenderFrame* render_take(void)
+{
+    al_lock_mutex(render.mutex);
+    if (render.fresh) {
+        int front = render.front;
+        render.front = render.ready;
+        render.ready = front;
+        render.fresh = false;
+    }
+    al_unlock_mutex(render.mutex);
+    return &render.frames[render.front];
+}
+
+/**
+ * @brief Rysuje klatkę z najnowszej migawki.
+ */
+static void render_frame(void)
+{
+    if (render.halted)
+        return;
+    const struct RenderFrame* F = render_take();
+    if (F->count == 0)
+        return;
+    const struct Layout* L = &F->layout;
+
+    // Nowy rozmiar okna przychodzi z ustawień razem z układem
+    if (L->width != render.width || L->height != render.height) {
+        change_resolution(render.display, L->width, L->height);
+        render.width = L->width;
+        render.height = L->height;
+    }
+    // Głośność z migawki, także dla utworu włączonego od ostatniej klatki
+    if (songStream && (songStream != render.song || F->volume != render.volume)) {
+        al_set_audio_stream_gain(songStream, F->volume);
+        render.song = songStream;
+        render.volume = F->volume;
+    }
+    // Zasoby sceny, która zwykle następuje po scenie na szczycie
+    int top = F->stack[F->count - 1];
+    if (top != render.top) {
+        render.top = top;
+        scene_prefetch(scene_next[top]);
+    }
+
+    // Ustawienia są nakładką, więc rysowanie zaczyna się od sceny pod nimi
+    int bottom = F->count - 1;
+    while (bottom > 0 && F->stack[bottom] == SCENE_SETTING)
+        bottom--;
+    for (int i = bottom; i < F->count; i++) {
+        switch (F->stack[i]) {
+        case SCENE_MENU: menu_draw(&F->menu, L); break;
+        case SCENE_GAME:
+            if (!render.atlas.bitmap || render.atlas.glyph != L->note_glyph)
+                notes_create_atlas(&render.atlas, L->note_glyph);
+            game_draw(&F->game, F->grid, &render.atlas, L);
+            break;
+        case SCENE_SETTING: setting_draw(&F->setting, L); break;
+        default: break;
+        }
+    }
+    al_flip_display();
+    render.frames_drawn++;
+
+    if (app_start_time > 0) {
+        fprintf(stderr, "Time to first frame: %.1f ms\n", (al_get_time() - app_start_time) * 1000.0);
+        app_start_time = 0;
+    }
+}
+
+/**
+ * @brief Wątek rysowania: przenosi zasoby do karty graficznej i rysuje klatki.
+ */
+static void* render_thread(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    (void)arg;
+    assets_use_thread();                // Tekstury, czcionki i muzyka są czytane także w tym wątku
+    al_set_target_backbuffer(render.display);
+
+    // Pierwsza klatka, gdy tylko gotowe są zasoby menu; reszta wczytuje się w tle
+    loader_wait(SCENE_MENU);
+    render_frame();
+
+    ALLEGRO_EVENT event;
+    bool running = true;
+    while (running) {
+        al_wait_for_event(render.queue, &event);
+        render.wakeups[render.background]++;
+
+        if (event.type == ALLEGRO_EVENT_TIMER) {
+            // Zaległy takt klatki: w kolejce czeka już nowszy, więc rysuje tylko ostatni
+            if (event.timer.count < al_get_timer_count(scenes.frame)) {
+                render.dropped_ticks++;
+                continue;
+            }
+            loader_poll();
+            check_song_finished();      // Następny utwór po zakończeniu bieżącego (w tle zegar stoi)
+            render_frame();
+            // Wolny czas klatki: jeden zasób następnej sceny
+            if (al_is_event_queue_empty(render.queue))
+                scene_prefetch_step(&render.frames[render.front].layout);
+            continue;
+        }
+
+        switch ((enum RenderCommand)event.user.data1) {
+        case RENDER_REDRAW:
+            render_frame();
+            break;
+        case RENDER_FOREGROUND:
+            // Okno jest odrysowywane od razu, bez czekania na pierwszy takt
+            render.background = false;
+            render_frame();
+            break;
+        case RENDER_BACKGROUND:
+            render.background = true;
+            break;
+        case RENDER_HALT:
+            render.halted = true;
+            al_acknowledge_drawing_halt(render.display);
+            break;
+        case RENDER_RESUME:
+            al_acknowledge_drawing_resume(render.display);
+            render.halted = false;
+            render_frame();
+            break;
+        case RENDER_STOP:
+            running = false;
+            break;
+        }
+    }
+
+    notes_destroy_atlas(&render.atlas);
+    al_set_target_bitmap(NULL);
+    return NULL;
+}
+
+/**
+ * @brief Przekazuje okno wątkowi rysowania i uruchamia go z pierwszą migawką.
+ *
+ * Od tej chwili wątek logiki nie rysuje i nie tworzy bitmap w pamięci karty graficznej.
+ *
+ * @param display Okno (bieżący cel rysowania wątku logiki).
+ */
+void render_start(ALLEGRO_DISPLAY* display)
+{
+    render.display = display;
+    render.width = layout.width;
+    render.height = layout.height;
+    render.top = -1;
+    render.front = 0;
+    render.ready = 1;
+    render.back = 2;
+    render.mutex = al_create_mutex();
+    render.queue = al_create_event_queue();
+    al_init_user_event_source(&render.commands);
+    al_register_event_source(render.queue, al_get_timer_event_source(scenes.frame));
+    al_register_event_source(render.queue, &render.commands);
+    render_publish();
+
+    // Okno może być celem rysowania tylko jednego wątku
+    al_set_target_bitmap(NULL);
+    render.bitmap_flags = al_get_new_bitmap_flags();
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+    render.thread = al_create_thread(render_thread, NULL);
+    if (!render.thread) exit(-6);
+    al_start_thread(render.thread);
+}
+
+/**
+ * @brief Kończy wątek rysowania i oddaje okno wątkowi logiki (do zwolnienia zasobów).
+ */
+void render_stop(void)
+{
+    render_command(RENDER_STOP);
+    al_join_thread(render.thread, NULL);
+    al_destroy_thread(render.thread);
+    al_destroy_event_queue(render.queue);
+    al_destroy_user_event_source(&render.commands);
+    al_destroy_mutex(render.mutex);
+
+    al_set_new_bitmap_flags(render.bitmap_flags);
+    al_set_target_backbuffer(render.display);
+}
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file saves.h
+ * @brief Obsługa slotów zapisu gry oraz pliku indeksu ze skróconymi metadanymi.
+ *
+ * Każdy slot ma własny plik z pełnym stanem gry (save_N.dat). Plik indeksu (saves.idx)
+ * przechowuje tylko metadane slotów: poziom trudności, czas gry, liczbę wypełnionych
+ * komórek i czas ostatniej gry. Menu czyta wyłącznie indeks, a pełny zapis jest
+ * wczytywany dopiero po wybraniu slotu.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include "structs.h"
+#include "define.h"
+
+#ifndef SAVES
+#define SAVES
+
+/**
+ * @brief Nazwa pliku indeksu slotów.
+ */
+#define SAVE_INDEX_FILE "saves.idx"
+
+/**
+ * @brief Znacznik pliku indeksu ("SDKI").
+ */
+#define SAVE_INDEX_MAGIC 0x494B4453u
+
+/**
+ * @brief Wersja formatu pliku indeksu.
+ */
+#define SAVE_INDEX_VERSION 2u
+
+/**
+ * @brief Plik zapisu z wersji gry bez slotów (przenoszony do pierwszego slotu).
+ */
+#define SAVE_LEGACY_FILE "save.dat"
+
+/**
+ * @brief Znacznik części dodatkowej zapisu ("SDKX").
+ */
+#define SAVE_EXTRA_MAGIC 0x584B4453u
+
+/**
+ * @brief Wersja części dodatkowej zapisu.
+ */
+#define SAVE_EXTRA_VERSION 2u
+
+/**
+ * @brief Rozmiar części dodatkowej w wersji 1 (bez zaimportowanej planszy).
+ */
+#define SAVE_EXTRA_V1_SIZE offsetof(struct SaveExtra, has_board)
+
+/**
+ * @brief Tworzy ścieżkę do pliku danego slotu.
+ *
+ * @param slot Numer slotu.
+ * @param path Bufor na ścieżkę.
+ * @param size Rozmiar bufora.
+ */
+void slot_path(int slot, char* path, size_t size)
+{
+    snprintf(path, size, "save_%d.dat", slot);
+}
+
+/**
+ * @brief Zapisuje indeks slotów.
+ *
+ * @param index Indeks do zapisania.
+ * @return true, jeśli zapis powiódł się, w przeciwnym razie false.
+ */
+bool save_index(const struct SaveIndex* index)
+{
+    FILE* file = fopen(SAVE_INDEX_FILE, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open save index for writing.\n");
+        return false;
+    }
+    bool ok = fwrite(index, sizeof(struct SaveIndex), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Przenosi zapis z wersji gry bez slotów (save.dat) do pierwszego slotu.
+ *
+ * Wywoływana, gdy nie ma pliku indeksu. Poziom trudności starego zapisu nie jest
+ * znany, więc slot dostaje poziom "Custom".
+ *
+ * @param index Indeks, w którym zostanie utworzony wpis slotu (wyzerowany wcześniej).
+ * @return true, jeśli zapis został przeniesiony.
+ */
+static bool migrate_legacy_save(struct SaveIndex* index)
+{
+    FILE* file = fopen(SAVE_LEGACY_FILE, "rb");
+    if (!file)
+        return false;
+    struct GameStateV1 old;
+    bool ok = fread(&old, sizeof(struct GameStateV1), 1, file) == 1;
+    fclose(file);
+
+    char path[32];
+    slot_path(0, path, sizeof(path));
+    if (!ok || rename(SAVE_LEGACY_FILE, path) != 0) {
+        fprintf(stderr, "Unable to move %s to save slot 1.\n", SAVE_LEGACY_FILE);
+        return false;
+    }
+
+    // The slot file is read like any version 1 save; the index gets its metadata
+    struct SlotInfo* info = &index->slots[0];
+    info->used = 1;
+    info->time_ms = old.time_count * 1000u;
+    for (int i = 0; i < 9; i++)
+        for (int j = 0; j < 9; j++)
+            if (old.matrix_area[i][j] != 0)
+                info->filled++;
+    info->last_played = (long long)time(NULL);
+    return save_index(index);
+}
+
+/**
+ * @brief Wczytuje indeks slotów.
+ *
+ * Jeśli plik nie istnieje lub jest uszkodzony, indeks jest zerowany (wszystkie sloty puste).
+ * Gdy pliku nie ma, a istnieje zapis z wersji bez slotów, trafia on do pierwszego slotu.
+ * Indeks w wersji 1 (czas w sekundach) jest przeliczany na milisekundy.
+ *
+ * @param index Struktura, do której zostanie wczytany indeks.
+ * @return true, jeśli indeks został wczytany z pliku (lub utworzony dla przeniesionego zapisu).
+ */
+bool load_index(struct SaveIndex* index)
+{
+    FILE* file = fopen(SAVE_INDEX_FILE, "rb");
+    bool ok = false;
+    if (file) {
+        ok = fread(index, sizeof(struct SaveIndex), 1, file) == 1
+            && index->magic == SAVE_INDEX_MAGIC && (index->version == SAVE_INDEX_VERSION || index->version == 1u);
+        fclose(file);
+    }
+    if (ok && index->version == 1u) {
+        for (int i = 0; i < SAVE_SLOTS; i++)
+            index->slots[i].time_ms *= 1000u;
+        index->version = SAVE_INDEX_VERSION;
+    }
+    if (!ok) {
+        memset(index, 0, sizeof(struct SaveIndex));
+        index->magic = SAVE_INDEX_MAGIC;
+        index->version = SAVE_INDEX_VERSION;
+        if (!file)
+            ok = migrate_legacy_save(index);
+    }
+    return ok;
+}
+
+/**
+ * @brief Sprawdza, czy którykolwiek slot zawiera zapis.
+ *
+ * @param index Wczytany indeks slotów.
+ * @return true, jeśli istnieje co najmniej jeden zapis.
+ */
+bool any_slot_used(const struct SaveIndex* index)
+{
+    for (int i = 0; i < SAVE_SLOTS; i++)
+        if (index->slots[i].used)
+            return true;
+    return false;
+}
+
+/**
+ * @brief Wybiera slot dla nowej gry.
+ *
+ * Zajęty slot nigdy nie jest wybierany – o nadpisaniu decyduje gracz (menu.h).
+ *
+ * @param index Wczytany indeks slotów.
+ * @return Numer pierwszego pustego slotu lub -1, jeśli wszystkie są zajęte.
+ */
+int find_free_slot(const struct SaveIndex* index)
+{
+    for (int i = 0; i < SAVE_SLOTS; i++)
+        if (!index->slots[i].used)
+            return i;
+    return -1;
+}
+
+/**
+ * @brief Funkcja zapisująca stan gry do slotu i aktualizująca indeks.
+ *
+ * @param slot Numer slotu.
+ * @param gameState Struktura przechowująca stan gry.
+ * @param info Metadane slotu zapisywane w indeksie.
+ * @param extra Notatki i dziennik cofania zapisywane po stanie gry.
+ * @return true, jeśli zapis powiódł się, w przeciwnym razie false.
+ */
+bool save_game(int slot, const struct GameState* gameState, struct SlotInfo info, const struct SaveExtra* extra) {
+    char path[32];
+    slot_path(slot, path, sizeof(path));
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open save file for writing.\n");
+        return false;
+    }
+    // Write data to file
+    struct SaveExtra header = *extra;
+    header.magic = SAVE_EXTRA_MAGIC;
+    header.version = SAVE_EXTRA_VERSION;
+    if (fwrite(gameState, sizeof(struct GameState), 1, file) != 1 || fwrite(&header, sizeof(struct SaveExtra), 1, file) != 1) {
+        fprintf(stderr, "Error writing to save file.\n");
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    struct SaveIndex index;
+    load_index(&index);
+    info.used = 1;
+    info.last_played = (long long)time(NULL);
+    index.slots[slot] = info;
+    return save_index(&index);
+}
+
+/**
+ * @brief Funkcja wczytująca stan gry z wybranego slotu.
+ *
+ * Zapisy w wersji 1 (struct GameStateV1) są rozpoznawane po rozmiarze pliku, a ich
+ * czas jest przeliczany na milisekundy. Zapis z cyfrą planszy spoza 0-9 albo liczbą
+ * wskazówek lub żyć spoza zakresu gry jest odrzucany.
+ *
+ * @param slot Numer slotu.
+ * @param gameState Struktura przechowująca stan gry.
+ * @param extra Struktura na notatki i dziennik cofania (wyzerowana, jeśli zapis ich nie zawiera).
+ * @return true, jeśli wczytywanie powiodło się, w przeciwnym razie false.
+ */
+bool load_game(int slot, struct GameState* gameState, struct SaveExtra* extra) {
+    memset(gameState, 0, sizeof(struct GameState));
+    memset(extra, 0, sizeof(struct SaveExtra));
+    char path[32];
+    slot_path(slot, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "No save file found.\n");
+        return false;
+    }
+    // Saves from version 1 store the time in seconds and have a larger game state
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bool ok;
+    if (size == (long)sizeof(struct GameStateV1) || size == (long)(sizeof(struct GameStateV1) + SAVE_EXTRA_V1_SIZE)) {
+        struct GameStateV1 old;
+        ok = fread(&old, sizeof(struct GameStateV1), 1, file) == 1;
+        memcpy(gameState->matrix_area, old.matrix_area, sizeof(gameState->matrix_area));
+        gameState->hints = old.hints;
+        gameState->hearts = old.hearts;
+        gameState->time_ms = old.time_count * 1000u;
+    }
+    else {
+        // Read data from the file
+        ok = fread(gameState, sizeof(struct GameState), 1, file) == 1;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error reading from save file.\n");
+        fclose(file);
+        memset(gameState, 0, sizeof(struct GameState));
+        return false;
+    }
+    // Digits outside 0-9 would index the unit masks out of range; counts must be the game's own
+    bool state_ok = gameState->hints >= 0 && gameState->hints <= TOTAL_CLUE && gameState->hearts >= 0 && gameState->hearts <= TOTAL_HEARTS;
+    for (int cell = 0; cell < 81; cell++)
+        if (gameState->matrix_area[cell / 9][cell % 9] < 0 || gameState->matrix_area[cell / 9][cell % 9] > 9)
+            state_ok = false;
+    if (!state_ok) {
+        fprintf(stderr, "Save file %s is corrupt.\n", path);
+        fclose(file);
+        memset(gameState, 0, sizeof(struct GameState));
+        return false;
+    }
+    // Notes and undo history; saves without them start with empty ones, version 1 has no imported board
+    size_t read = fread(extra, 1, sizeof(struct SaveExtra), file);
+    bool current = extra->version == SAVE_EXTRA_VERSION && read == sizeof(struct SaveExtra);
+    bool v1 = extra->version == 1u && read >= SAVE_EXTRA_V1_SIZE;
+    if (read < SAVE_EXTRA_V1_SIZE || extra->magic != SAVE_EXTRA_MAGIC || !(current || v1))
+        memset(extra, 0, sizeof(struct SaveExtra));
+    else if (!current) {
+        extra->has_board = 0;
+        memset(extra->board, 0, sizeof(extra->board));
+    }
+
+    // A corrupt or truncated slot starts with empty notes and undo history instead of indexing out of bounds
+    bool notes_ok = true;
+    bool board_ok = true;
+    for (int cell = 0; cell < 81; cell++) {
+        if (extra->notes[cell] > 0x1FF)
+            notes_ok = false;
+        if (extra->board[cell / 9][cell % 9] < 0 || extra->board[cell / 9][cell % 9] > 9)
+            board_ok = false;
+    }
+    if (!board_ok) {
+        extra->has_board = 0;
+        memset(extra->board, 0, sizeof(extra->board));
+    }
+    if (!notes_ok || !journal_valid(&extra->journal)) {
+        fprintf(stderr, "Save file has corrupt notes or undo history; they are reset.\n");
+        memset(extra->notes, 0, sizeof(extra->notes));
+        journal_clear(&extra->journal);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Usuwa zapis ze slotu i oznacza slot w indeksie jako pusty.
+ *
+ * @param slot Numer slotu.
+ */
+void delete_slot(int slot)
+{
+    char path[32];
+    slot_path(slot, path, sizeof(path));
+    // A game that was never saved has no file to remove
+    if (remove(path) != 0 && errno != ENOENT)
+        fprintf(stderr, "Unable to delete the file %s.\n", path);
+
+    struct SaveIndex index;
+    load_index(&index);
+    memset(&index.slots[slot], 0, sizeof(struct SlotInfo));
+    save_index(&index);
+}
+
+#endif
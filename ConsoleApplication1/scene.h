@@ -0,0 +1,294 @@
+/**
+ * @file scene.h
+ * @brief Stos scen i zasoby, które pozostają wczytane między scenami.
+ *
+ * Menu, gra i ustawienia są scenami na jednym stosie obsługiwanym przez jedną pętlę
+ * zdarzeń (app.h): zdarzenia trafiają do sceny na szczycie, a klatka rysowana jest od
+ * najwyższej sceny nieprzezroczystej w górę (ustawienia są nakładką na grę).
+ *
+ * Czcionki, zegar klatek i tekstury scen są tworzone raz i nie są zwalniane przy zmianie
+ * sceny. Gdy na szczycie stosu pojawi się scena, zasoby sceny, która zwykle następuje
+ * po niej, są wczytywane w tle po jednym na wolny takt zegara klatek, więc przejście
+ * do niej nie musi niczego wczytywać.
+ *
+ * Czcionki i tekstury należą do wątku rysowania (render.h). Wątek logiki mierzy
+ * tekst osobnymi czcionkami z bitmapami w pamięci (scene_measure_font).
+ *
+ * Przy starcie wszystkie obrazy, plik czcionki i pierwszy utwór dekodowane są
+ * równolegle przez loader.h; menu czeka tylko na własne zasoby.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+#include <allegro5/allegro_memfile.h>
+
+#include "define.h"
+#include "layout.h"
+#include "texture.h"
+#include "loader.h"
+
+#ifndef SCENE
+#define SCENE
+
+/**
+ * @brief Sceny programu.
+ */
+enum SceneId {
+    SCENE_MENU,             ///< Menu (ekran główny, poziomy trudności, sloty, statystyki).
+    SCENE_GAME,             ///< Gra wraz z oknem wyniku.
+    SCENE_SETTING,          ///< Ustawienia (nakładka na grę).
+    SCENE_COUNT             ///< Liczba scen.
+};
+
+/**
+ * @brief Czcionki scen.
+ */
+enum FontId {
+    FONT_TITLE,             ///< Nazwa gry w menu.
+    FONT_SLOTS,             ///< Przyciski tekstowe i wiersze menu.
+    FONT_GAME,              ///< Ekran gry.
+    FONT_SETTING,           ///< Ustawienia.
+    FONT_SONG,              ///< Nazwa utworu w ustawieniach.
+    FONT_COUNT              ///< Liczba czcionek.
+};
+
+/**
+ * @brief Maksymalna liczba obrazów sceny.
+ */
+#define SCENE_IMAGES 20
+
+/**
+ * @struct Scenes
+ * @brief Stos scen i ich zasoby.
+ */
+struct Scenes {
+    enum SceneId stack[SCENE_COUNT];    ///< Sceny od dołu do szczytu (każda co najwyżej raz).
+    int count;                          ///< Liczba scen na stosie.
+    int popped;                         ///< Scena zdjęta podczas ostatniego zdarzenia lub -1.
+    ALLEGRO_DISPLAY* display;           ///< Okno.
+    ALLEGRO_EVENT_QUEUE* queue;         ///< Wspólna kolejka zdarzeń.
+    ALLEGRO_TIMER* frame;               ///< Zegar klatek (FPS).
+    ALLEGRO_FONT* font[FONT_COUNT];     ///< Czcionki (wątek rysowania).
+    int font_size[FONT_COUNT];          ///< Rozmiary wczytanych czcionek.
+    ALLEGRO_FONT* measure[FONT_COUNT];  ///< Czcionki do mierzenia tekstu (wątek logiki).
+    int measure_size[FONT_COUNT];       ///< Rozmiary czcionek do mierzenia.
+    int prefetch;                       ///< Scena, której zasoby są wczytywane w tle, lub -1.
+    int prefetch_next;                  ///< Następny zasób tej sceny.
+};
+
+/**
+ * @brief Stos scen programu.
+ */
+struct Scenes scenes;
+
+/**
+ * @brief Obrazy scen (wczytywane z wyprzedzeniem do pamięci podręcznej tekstur; ASSET_COUNT kończy listę).
+ */
+static const enum AssetId scene_images[SCENE_COUNT][SCENE_IMAGES] = {
+    [SCENE_MENU] = { ASSET_MENU_BG, ASSET_START, ASSET_CONTINUE, ASSET_EASY, ASSET_MID, ASSET_HARD,
+        ASSET_LEFT_ARROW, ASSET_COUNT },
+    [SCENE_GAME] = { ASSET_BACKGROUND, ASSET_NUMBERS_1, ASSET_NUMBERS_2, ASSET_NUMBERS_3, ASSET_NUMBERS_4,
+        ASSET_NUMBERS_5, ASSET_NUMBERS_6, ASSET_NUMBERS_7, ASSET_NUMBERS_8, ASSET_NUMBERS_9, ASSET_NUMBERS_FRAME,
+        ASSET_CLUE, ASSET_ICON_SETTING, ASSET_EXIT, ASSET_HEART, ASSET_RESULT_BOX, ASSET_RESTART, ASSET_COUNT },
+    [SCENE_SETTING] = { ASSET_SETTING, ASSET_ACCEPT, ASSET_CANCEL, ASSET_RIGHT_ARROW, ASSET_LEFT_ARROW,
+        ASSET_SLIDERBACKGROUND, ASSET_SLIDER, ASSET_COUNT },
+};
+
+/**
+ * @brief Czcionki scen (FONT_COUNT kończy listę).
+ */
+static const enum FontId scene_fonts[SCENE_COUNT][3] = {
+    [SCENE_MENU] = { FONT_TITLE, FONT_SLOTS, FONT_COUNT },
+    [SCENE_GAME] = { FONT_GAME, FONT_COUNT, FONT_COUNT },
+    [SCENE_SETTING] = { FONT_SETTING, FONT_SONG, FONT_COUNT },
+};
+
+/**
+ * @brief Scena, która zwykle następuje po danej (-1 – brak).
+ */
+static const int scene_next[SCENE_COUNT] = {
+    [SCENE_MENU] = SCENE_GAME,
+    [SCENE_GAME] = SCENE_SETTING,
+    [SCENE_SETTING] = -1,
+};
+
+/**
+ * @brief Tworzy i uruchamia zegar klatek (jego zdarzenia odbiera wątek rysowania).
+ *
+ * @param display Okno.
+ * @param queue Wspólna kolejka zdarzeń.
+ */
+void scenes_init(ALLEGRO_DISPLAY* display, ALLEGRO_EVENT_QUEUE* queue)
+{
+    memset(&scenes, 0, sizeof(scenes));
+    scenes.popped = -1;
+    scenes.prefetch = -1;
+    scenes.display = display;
+    scenes.queue = queue;
+    scenes.frame = al_create_timer(1.0 / FPS);
+    al_start_timer(scenes.frame);
+}
+
+/**
+ * @brief Zwalnia czcionki i zegar klatek.
+ */
+void scenes_destroy(void)
+{
+    for (int i = 0; i < FONT_COUNT; i++) {
+        if (scenes.font[i])
+            al_destroy_font(scenes.font[i]);
+        if (scenes.measure[i])
+            al_destroy_font(scenes.measure[i]);
+    }
+    al_destroy_timer(scenes.frame);
+}
+
+/**
+ * @brief Zwraca rozmiar czcionki dla układu.
+ */
+static int scene_font_size(enum FontId id, const struct Layout* L)
+{
+    switch (id) {
+    case FONT_TITLE: return SIZE_FONT;
+    case FONT_SLOTS: return SIZE_FONT / 2;
+    case FONT_GAME: return L->font_size;
+    case FONT_SETTING: return L->setting_font;
+    default: return L->song_font;
+    }
+}
+
+/**
+ * @brief Zwraca czcionkę, wczytując ją tylko, gdy zmienił się jej rozmiar (wątek rysowania).
+ *
+ * @param id Czcionka.
+ * @param L Układ rysowanej klatki.
+ * @return Czcionka w rozmiarze dla układu.
+ */
+ALLEGRO_FONT* scene_font(enum FontId id, const struct Layout* L)
+{
+    int size = scene_font_size(id, L);
+    if (scenes.font[id] && scenes.font_size[id] == size)
+        return scenes.font[id];
+    if (scenes.font[id])
+        al_destroy_font(scenes.font[id]);
+    // Plik czcionki wczytany przez loader.h jest tylko parsowany z pamięci
+    if (loader.font_data)
+        scenes.font[id] = al_load_ttf_font_f(al_open_memfile(loader.font_data, (int64_t)loader.font_size, "r"), NULL, size, 0);
+    else
+        scenes.font[id] = al_load_ttf_font(asset_path(ASSET_TENADA), size, 0);
+    if (!scenes.font[id]) exit(-2);
+    scenes.font_size[id] = size;
+    return scenes.font[id];
+}
+
+/**
+ * @brief Zwraca czcionkę do mierzenia tekstu w wątku logiki dla aktualnego układu.
+ *
+ * Wątek logiki nie ma okna, więc bitmapy znaków tej czcionki są bitmapami w pamięci
+ * (flagi ustawia render_start).
+ *
+ * @param id Czcionka.
+ * @return Czcionka w rozmiarze dla aktualnego układu.
+ */
+ALLEGRO_FONT* scene_measure_font(enum FontId id)
+{
+    int size = scene_font_size(id, &layout);
+    if (scenes.measure[id] && scenes.measure_size[id] == size)
+        return scenes.measure[id];
+    if (scenes.measure[id])
+        al_destroy_font(scenes.measure[id]);
+    scenes.measure[id] = al_load_ttf_font(asset_path(ASSET_TENADA), size, 0);
+    if (!scenes.measure[id]) exit(-2);
+    scenes.measure_size[id] = size;
+    return scenes.measure[id];
+}
+
+/**
+ * @brief Kolejkuje w loader.h obrazy wszystkich scen (od menu), plik czcionki i pierwszy utwór.
+ */
+void scenes_load(void)
+{
+    for (int id = 0; id < SCENE_COUNT; id++)
+        for (int i = 0; i < SCENE_IMAGES && scene_images[id][i] != ASSET_COUNT; i++)
+            loader_add(scene_images[id][i], ASSET_IMAGE, id);
+    loader_add(ASSET_TENADA, ASSET_FONT, SCENE_MENU);
+    loader_add(rand_song(), ASSET_MUSIC, -1);
+    loader_start();
+}
+
+/**
+ * @brief Rozpoczyna wczytywanie zasobów sceny w tle.
+ *
+ * @param id Scena lub -1.
+ */
+void scene_prefetch(int id)
+{
+    scenes.prefetch = id;
+    scenes.prefetch_next = 0;
+}
+
+/**
+ * @brief Wczytuje jeden brakujący zasób sceny wskazanej przez scene_prefetch (wątek rysowania).
+ *
+ * @param L Układ ostatniej klatki (rozmiary czcionek).
+ * @return true, jeśli coś zostało wczytane.
+ */
+bool scene_prefetch_step(const struct Layout* L)
+{
+    int id = scenes.prefetch;
+    if (id < 0)
+        return false;
+
+    // Najpierw obrazy, potem czcionki; zasoby już wczytane są pomijane
+    while (scenes.prefetch_next < SCENE_IMAGES && scene_images[id][scenes.prefetch_next] != ASSET_COUNT) {
+        enum AssetId image = scene_images[id][scenes.prefetch_next++];
+        if (!texture_loaded(image) && !loader_pending(image)) {
+            texture_get(image);
+            return true;
+        }
+    }
+    scenes.prefetch_next = SCENE_IMAGES;
+    for (int i = 0; i < 3 && scene_fonts[id][i] != FONT_COUNT; i++) {
+        enum FontId font = scene_fonts[id][i];
+        if (!scenes.font[font] || scenes.font_size[font] != scene_font_size(font, L)) {
+            scene_font(font, L);
+            return true;
+        }
+    }
+    scenes.prefetch = -1;
+    return false;
+}
+
+/**
+ * @brief Zwraca scenę na szczycie stosu.
+ *
+ * @return Scena lub -1 dla pustego stosu.
+ */
+int scene_top(void)
+{
+    return scenes.count ? (int)scenes.stack[scenes.count - 1] : -1;
+}
+
+/**
+ * @brief Kładzie scenę na stos.
+ *
+ * @param id Scena.
+ */
+void scene_push(enum SceneId id)
+{
+    scenes.stack[scenes.count++] = id;
+}
+
+/**
+ * @brief Zdejmuje scenę ze szczytu stosu.
+ */
+void scene_pop(void)
+{
+    scenes.popped = scenes.stack[--scenes.count];
+}
+
+#endif
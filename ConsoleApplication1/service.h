@@ -0,0 +1,347 @@
+/**
+ * @file service.h
+ * @brief Usługa rozwiązywania plansz w wątku roboczym.
+ *
+ * Wątek logiki nie uruchamia przeszukiwania: wysyła żądanie (sprawdzenie ruchu,
+ * podpowiedź dla komórki, liczba rozwiązań, wygenerowanie planszy) do kolejki
+ * usługi, a wynik wraca jako zdarzenie SOLVE_EVENT w kolejce zdarzeń programu. Każde żądanie ma budżet czasu
+ * i węzłów przeszukiwania, więc patologiczna plansza kończy się wynikiem
+ * SOLVE_EXPIRED zamiast zablokowania usługi. Generowanie planszy jest ograniczone
+ * liczbą prób (SOLVE_GENERATE_ATTEMPTS) oraz budżetem czasu i unieważnieniem
+ * sprawdzanymi po każdej próbie.
+ *
+ * Żądanie pamięta generację planszy, z której pochodzi. Zmiana planszy
+ * (solve_board_changed) unieważnia wszystkie starsze żądania: czekające w kolejce są
+ * pomijane, a rozwiązywane jest przerywane i nie zwraca wyniku. Tak samo działa
+ * anulowanie pojedynczego żądania (solve_cancel).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+
+#include "solver.h"
+#include "queue.h"
+#include "generator.h"
+
+#ifndef SERVICE
+#define SERVICE
+
+/**
+ * @brief Typ zdarzeń z wynikami usługi ("SDKS"); user.data1 wskazuje struct SolveResult.
+ */
+#define SOLVE_EVENT ALLEGRO_GET_EVENT_TYPE('S', 'D', 'K', 'S')
+
+/**
+ * @brief Maksymalna liczba żądań czekających w kolejce usługi.
+ */
+#define SOLVE_QUEUE_SIZE 16
+
+/**
+ * @brief Domyślny budżet czasu żądania w sekundach.
+ */
+#define SOLVE_TIME_BUDGET 2.0
+
+/**
+ * @brief Domyślny budżet węzłów przeszukiwania żądania.
+ */
+#define SOLVE_NODE_BUDGET 10000000LL
+
+/**
+ * @brief Maksymalna liczba plansz losowanych przy generowaniu planszy poziomu.
+ */
+#define SOLVE_GENERATE_ATTEMPTS 64
+
+/**
+ * @brief Rodzaje żądań.
+ */
+enum SolveKind {
+    SOLVE_VALIDATE,         ///< Czy plansza z cyfrą wpisaną do komórki ma rozwiązanie.
+    SOLVE_HINT,             ///< Cyfra komórki w rozwiązaniu planszy.
+    SOLVE_COUNT,            ///< Liczba rozwiązań planszy (do limitu) i pierwsze rozwiązanie.
+    SOLVE_GENERATE          ///< Nowa plansza poziomu (generator.h), gdy bank jej nie ma.
+};
+
+/**
+ * @brief Stan zakończonego żądania.
+ */
+enum SolveStatus {
+    SOLVE_DONE,             ///< Przeszukiwanie zakończone.
+    SOLVE_EXPIRED           ///< Wyczerpany budżet czasu lub węzłów; wynik jest niepełny.
+};
+
+/**
+ * @struct SolveRequest
+ * @brief Żądanie do usługi.
+ */
+struct SolveRequest {
+    int id;                     ///< Identyfikator (nadaje solve_submit).
+    enum SolveKind kind;        ///< Rodzaj żądania.
+    unsigned int generation;    ///< Generacja planszy (nadaje solve_submit).
+    int board[9][9];            ///< Plansza.
+    int row;                    ///< Wiersz komórki (SOLVE_VALIDATE, SOLVE_HINT).
+    int column;                 ///< Kolumna komórki (SOLVE_VALIDATE, SOLVE_HINT).
+    int digit;                  ///< Sprawdzana cyfra (SOLVE_VALIDATE).
+    int limit;                  ///< Maksymalna liczba szukanych rozwiązań (SOLVE_GENERATE – liczba prób).
+    int level;                  ///< Poziom trudności (SOLVE_GENERATE).
+    unsigned int seed;          ///< Ziarno generatora (SOLVE_GENERATE).
+    double seconds;             ///< Budżet czasu w sekundach.
+    long long max_nodes;        ///< Budżet węzłów przeszukiwania.
+};
+
+/**
+ * @struct SolveResult
+ * @brief Wynik żądania.
+ */
+struct SolveResult {
+    int id;                     ///< Identyfikator żądania.
+    enum SolveKind kind;        ///< Rodzaj żądania.
+    unsigned int generation;    ///< Generacja planszy żądania.
+    enum SolveStatus status;    ///< Stan zakończenia.
+    int row;                    ///< Wiersz komórki z żądania.
+    int column;                 ///< Kolumna komórki z żądania.
+    int digit;                  ///< Cyfra z żądania (SOLVE_VALIDATE) lub z rozwiązania (SOLVE_HINT).
+    int count;                  ///< Liczba znalezionych rozwiązań (do limitu); SOLVE_GENERATE – 1, gdy plansza ma żądany poziom.
+    int solution[9][9];         ///< Pierwsze rozwiązanie (ważne, gdy count > 0); SOLVE_GENERATE – wygenerowana plansza.
+    long long nodes;            ///< Odwiedzone węzły.
+    double seconds;             ///< Czas rozwiązywania.
+};
+
+/**
+ * @struct SolveService
+ * @brief Wątek usługi, jego kolejka i stan unieważniania żądań.
+ */
+struct SolveService {
+    struct BoundedQueue requests;   ///< Żądania czekające na wątek.
+    ALLEGRO_THREAD* thread;         ///< Wątek roboczy.
+    ALLEGRO_EVENT_SOURCE results;   ///< Źródło zdarzeń SOLVE_EVENT.
+    ALLEGRO_MUTEX* mutex;           ///< Chroni generation i cancel_id.
+    unsigned int generation;        ///< Aktualna generacja planszy.
+    int cancel_id;                  ///< Ostatnie anulowane żądanie.
+    int next_id;                    ///< Identyfikator następnego żądania (wątek logiki).
+    bool running;                   ///< Czy wątek działa.
+};
+
+/**
+ * @brief Usługa rozwiązywania programu.
+ */
+struct SolveService solve_service;
+
+/**
+ * @struct SolveJob
+ * @brief Rozwiązywane żądanie i jego termin (argument funkcji expired budżetu).
+ */
+struct SolveJob {
+    const struct SolveRequest* request;     ///< Żądanie.
+    double deadline;                        ///< Koniec budżetu czasu (al_get_time).
+};
+
+/**
+ * @brief Sprawdza, czy żądanie zostało unieważnione (zmiana planszy lub anulowanie).
+ */
+static bool solve_stale(const struct SolveRequest* request)
+{
+    al_lock_mutex(solve_service.mutex);
+    bool stale = request->generation != solve_service.generation || request->id == solve_service.cancel_id;
+    al_unlock_mutex(solve_service.mutex);
+    return stale;
+}
+
+/**
+ * @brief Funkcja expired budżetu: koniec czasu albo unieważnione żądanie.
+ */
+static bool solve_expired(void* arg)
+{
+    const struct SolveJob* job = arg;
+    return al_get_time() > job->deadline || solve_stale(job->request);
+}
+
+/**
+ * @brief Zwalnia wynik po obsłużeniu zdarzenia (destruktor zdarzenia użytkownika).
+ */
+static void solve_free_result(ALLEGRO_USER_EVENT* event)
+{
+    free((void*)event->data1);
+}
+
+/**
+ * @brief Rozwiązuje żądanie w ramach jego budżetu.
+ *
+ * @param request Żądanie.
+ * @param result Wynik.
+ */
+static void solve_run(const struct SolveRequest* request, struct SolveResult* result)
+{
+    double start = al_get_time();
+    struct SolveJob job = { request, start + request->seconds };
+    struct SolverBudget budget = { request->max_nodes, solve_expired, &job, 0, false };
+
+    int board[9][9];
+    memcpy(board, request->board, sizeof(board));
+    if (request->kind == SOLVE_VALIDATE)
+        board[request->row][request->column] = request->digit;
+
+    memset(result, 0, sizeof(*result));
+    result->id = request->id;
+    result->kind = request->kind;
+    result->generation = request->generation;
+    result->row = request->row;
+    result->column = request->column;
+    result->digit = request->digit;
+    if (request->kind == SOLVE_GENERATE) {
+        // Ostatnia wylosowana plansza, nawet jeśli żadna nie trafiła w poziom albo skończył się czas;
+        // anulowanie lub zmiana planszy przerywa generowanie po bieżącej próbie
+        unsigned int seed = request->seed;
+        result->count = generate_puzzle(request->level, result->solution, &seed, request->limit, &budget) ? 1 : 0;
+        result->status = budget.aborted ? SOLVE_EXPIRED : SOLVE_DONE;
+        result->seconds = al_get_time() - start;
+        return;
+    }
+    result->count = count_solutions_budget(board, request->limit, result->solution, &budget);
+    result->status = budget.aborted ? SOLVE_EXPIRED : SOLVE_DONE;
+    result->nodes = budget.nodes;
+    result->seconds = al_get_time() - start;
+    if (request->kind == SOLVE_HINT)
+        result->digit = result->count > 0 ? result->solution[request->row][request->column] : 0;
+}
+
+/**
+ * @brief Wątek usługi: rozwiązuje żądania po kolei i wysyła wyniki jako zdarzenia.
+ */
+static void* solve_worker(ALLEGRO_THREAD* thread, void* arg)
+{
+    (void)thread;
+    (void)arg;
+    struct SolveRequest request;
+    while (queue_pop(&solve_service.requests, &request)) {
+        if (solve_stale(&request))
+            continue;
+        struct SolveResult* result = malloc(sizeof(struct SolveResult));
+        if (!result)
+            continue;
+        solve_run(&request, result);
+
+        // Przerwane przez unieważnienie – nikt nie czeka już na ten wynik
+        if (solve_stale(&request)) {
+            free(result);
+            continue;
+        }
+        ALLEGRO_EVENT event;
+        memset(&event, 0, sizeof(event));
+        event.user.type = SOLVE_EVENT;
+        event.user.data1 = (intptr_t)result;
+        if (!al_emit_user_event(&solve_service.results, &event, solve_free_result))
+            free(result);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Uruchamia usługę; jej wyniki trafiają do podanej kolejki zdarzeń.
+ *
+ * @param event_queue Kolejka zdarzeń wątku logiki.
+ * @return false, jeśli nie udało się utworzyć wątku (żądania są wtedy odrzucane).
+ */
+bool solve_start(ALLEGRO_EVENT_QUEUE* event_queue)
+{
+    memset(&solve_service, 0, sizeof(solve_service));
+    solve_service.next_id = 1;
+    solve_service.mutex = al_create_mutex();
+    al_init_user_event_source(&solve_service.results);
+    al_register_event_source(event_queue, &solve_service.results);
+    if (!queue_create(&solve_service.requests, sizeof(struct SolveRequest), SOLVE_QUEUE_SIZE))
+        return false;
+    solve_service.thread = al_create_thread(solve_worker, NULL);
+    if (!solve_service.thread) {
+        fprintf(stderr, "Failed to start the solver service\n");
+        return false;
+    }
+    al_start_thread(solve_service.thread);
+    solve_service.running = true;
+    return true;
+}
+
+/**
+ * @brief Wypełnia żądanie domyślnym budżetem.
+ *
+ * @param request Żądanie.
+ * @param kind Rodzaj żądania.
+ * @param board Plansza.
+ */
+void solve_request(struct SolveRequest* request, enum SolveKind kind, const int board[9][9])
+{
+    memset(request, 0, sizeof(*request));
+    request->kind = kind;
+    memcpy(request->board, board, sizeof(request->board));
+    request->row = -1;
+    request->column = -1;
+    request->limit = kind == SOLVE_COUNT ? 2 : kind == SOLVE_GENERATE ? SOLVE_GENERATE_ATTEMPTS : 1;
+    request->seconds = SOLVE_TIME_BUDGET;
+    request->max_nodes = SOLVE_NODE_BUDGET;
+}
+
+/**
+ * @brief Wysyła żądanie dla aktualnej generacji planszy (nie blokuje).
+ *
+ * @param request Żądanie (uzupełniane są id i generation).
+ * @return Identyfikator żądania lub 0, jeśli usługa nie działa albo kolejka jest pełna.
+ */
+int solve_submit(struct SolveRequest* request)
+{
+    if (!solve_service.running)
+        return 0;
+    request->id = solve_service.next_id++;
+    al_lock_mutex(solve_service.mutex);
+    request->generation = solve_service.generation;
+    al_unlock_mutex(solve_service.mutex);
+    return queue_try_push(&solve_service.requests, request) ? request->id : 0;
+}
+
+/**
+ * @brief Anuluje żądanie: nie zostanie rozwiązane, a rozwiązywane jest przerywane.
+ *
+ * @param id Identyfikator żądania.
+ */
+void solve_cancel(int id)
+{
+    al_lock_mutex(solve_service.mutex);
+    solve_service.cancel_id = id;
+    al_unlock_mutex(solve_service.mutex);
+}
+
+/**
+ * @brief Unieważnia wszystkie żądania wysłane dla poprzedniej planszy.
+ *
+ * @return Nowa generacja planszy.
+ */
+unsigned int solve_board_changed(void)
+{
+    al_lock_mutex(solve_service.mutex);
+    unsigned int generation = ++solve_service.generation;
+    al_unlock_mutex(solve_service.mutex);
+    return generation;
+}
+
+/**
+ * @brief Zatrzymuje usługę (przerywa rozwiązywane żądanie i czeka na wątek).
+ */
+void solve_stop(void)
+{
+    if (solve_service.running) {
+        queue_close(&solve_service.requests);
+        solve_board_changed();
+        al_join_thread(solve_service.thread, NULL);
+        al_destroy_thread(solve_service.thread);
+        solve_service.running = false;
+    }
+    if (solve_service.requests.items)
+        queue_destroy(&solve_service.requests);
+    al_destroy_user_event_source(&solve_service.results);
+    al_destroy_mutex(solve_service.mutex);
+}
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file solver.h
+ * @brief Szybki solver Sudoku oparty na maskach bitowych.
+ *
+ * Każda jednostka planszy (wiersz, kolumna, kwadrat 3x3 i grupa pozycji – komórki
+ * o tej samej pozycji wewnątrz kwadratów, zgodnie z is_poz) ma 9-bitową maskę
+ * zajętych cyfr. Kandydaci komórki to dopełnienie sumy masek jej czterech jednostek,
+ * a przeszukiwanie wybiera zawsze komórkę z najmniejszą liczbą kandydatów.
+ * Solver potrafi policzyć rozwiązania do zadanego limitu, co pozwala sprawdzić,
+ * czy plansza ma dokładnie jedno rozwiązanie.
+ *
+ * Przeszukiwanie można ograniczyć budżetem (struct SolverBudget): limitem węzłów
+ * i funkcją sprawdzaną co SOLVER_CHECK_NODES węzłów, która przerywa je np. po
+ * przekroczeniu czasu albo anulowaniu żądania (service.h).
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef SOLVER
+#define SOLVER
+
+/**
+ * @brief Maska wszystkich cyfr 1-9.
+ */
+#define ALL_DIGITS 0x1FF
+
+/**
+ * @brief Co ile węzłów przeszukiwanie wywołuje funkcję expired budżetu.
+ */
+#define SOLVER_CHECK_NODES 1024
+
+/**
+ * @struct SolverBudget
+ * @brief Ograniczenie przeszukiwania i jego wynik.
+ */
+struct SolverBudget {
+    long long max_nodes;            ///< Limit odwiedzonych węzłów (0 – bez limitu).
+    bool (*expired)(void* arg);     ///< Zwraca true, gdy przeszukiwanie ma się zakończyć (NULL – nigdy).
+    void* arg;                      ///< Argument funkcji expired.
+    long long nodes;                ///< Odwiedzone węzły (wynik).
+    bool aborted;                   ///< Czy przeszukiwanie zostało przerwane (wynik).
+};
+
+/**
+ * @struct Solver
+ * @brief Stan solvera: plansza i maski zajętości jednostek.
+ */
+struct Solver {
+    int grid[81];               ///< Plansza (0 – pusta komórka).
+    unsigned short row[9];      ///< Cyfry zajęte w wierszach.
+    unsigned short col[9];      ///< Cyfry zajęte w kolumnach.
+    unsigned short box[9];      ///< Cyfry zajęte w kwadratach 3x3.
+    unsigned short pos[9];      ///< Cyfry zajęte w grupach pozycji.
+    long long nodes;            ///< Liczba odwiedzonych węzłów przeszukiwania.
+    struct SolverBudget* budget;    ///< Budżet przeszukiwania lub NULL.
+    bool aborted;               ///< Przeszukiwanie przerwane po wyczerpaniu budżetu.
+};
+
+/**
+ * @brief Zwraca numer kwadratu 3x3 komórki.
+ */
+static int box_of(int row, int column)
+{
+    return (row / 3) * 3 + column / 3;
+}
+
+/**
+ * @brief Zwraca numer grupy pozycji komórki (pozycja wewnątrz kwadratu 3x3).
+ */
+static int pos_of(int row, int column)
+{
+    return (row % 3) * 3 + column % 3;
+}
+
+/**
+ * @brief Liczy ustawione bity w masce 9-bitowej.
+ */
+static int bit_count(unsigned int mask)
+{
+    int count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Zamienia pojedynczy bit maski na cyfrę 1-9.
+ */
+static int bit_digit(unsigned int bit)
+{
+    int digit = 1;
+    while (bit >>= 1)
+        digit++;
+    return digit;
+}
+
+/**
+ * @brief Zwraca maskę kandydatów pustej komórki.
+ *
+ * @param s Stan solvera.
+ * @param cell Indeks komórki (0-80).
+ * @return Maska cyfr, które można wpisać do komórki.
+ */
+static unsigned int solver_candidates(const struct Solver* s, int cell)
+{
+    int r = cell / 9, c = cell % 9;
+    return ~(s->row[r] | s->col[c] | s->box[box_of(r, c)] | s->pos[pos_of(r, c)]) & ALL_DIGITS;
+}
+
+/**
+ * @brief Wpisuje cyfrę do komórki i aktualizuje maski.
+ */
+static void solver_place(struct Solver* s, int cell, int digit)
+{
+    int r = cell / 9, c = cell % 9;
+    unsigned short bit = (unsigned short)(1u << (digit - 1));
+    s->grid[cell] = digit;
+    s->row[r] |= bit;
+    s->col[c] |= bit;
+    s->box[box_of(r, c)] |= bit;
+    s->pos[pos_of(r, c)] |= bit;
+}
+
+/**
+ * @brief Usuwa cyfrę z komórki i aktualizuje maski.
+ */
+static void solver_remove(struct Solver* s, int cell)
+{
+    int r = cell / 9, c = cell % 9;
+    unsigned short bit = (unsigned short)~(1u << (s->grid[cell] - 1));
+    s->grid[cell] = 0;
+    s->row[r] &= bit;
+    s->col[c] &= bit;
+    s->box[box_of(r, c)] &= bit;
+    s->pos[pos_of(r, c)] &= bit;
+}
+
+/**
+ * @brief Inicjalizuje solver planszą.
+ *
+ * @param s Stan solvera.
+ * @param grid Plansza (0 – pusta komórka).
+ * @return false, jeśli podane cyfry są ze sobą sprzeczne.
+ */
+bool solver_init(struct Solver* s, const int grid[9][9])
+{
+    memset(s, 0, sizeof(struct Solver));
+    for (int cell = 0; cell < 81; cell++) {
+        int digit = grid[cell / 9][cell % 9];
+        if (digit == 0)
+            continue;
+        if (digit < 1 || digit > 9 || !(solver_candidates(s, cell) & (1u << (digit - 1))))
+            return false;
+        solver_place(s, cell, digit);
+    }
+    return true;
+}
+
+/**
+ * @brief Rekurencyjnie liczy rozwiązania do podanego limitu.
+ *
+ * @param s Stan solvera.
+ * @param limit Maksymalna liczba szukanych rozwiązań.
+ * @param count Liczba znalezionych rozwiązań.
+ * @param solution Bufor na pierwsze znalezione rozwiązanie lub NULL.
+ */
+static void solver_search(struct Solver* s, int limit, int* count, int solution[81])
+{
+    s->nodes++;
+    if (s->budget) {
+        const struct SolverBudget* b = s->budget;
+        if ((b->max_nodes > 0 && s->nodes > b->max_nodes) ||
+            (b->expired && s->nodes % SOLVER_CHECK_NODES == 0 && b->expired(b->arg))) {
+            s->aborted = true;
+            return;
+        }
+    }
+
+    // Komórka z najmniejszą liczbą kandydatów
+    int best = -1, best_count = 10;
+    unsigned int best_mask = 0;
+    for (int cell = 0; cell < 81; cell++) {
+        if (s->grid[cell])
+            continue;
+        unsigned int mask = solver_candidates(s, cell);
+        int n = bit_count(mask);
+        if (n < best_count) {
+            best = cell;
+            best_count = n;
+            best_mask = mask;
+            if (n <= 1)
+                break;
+        }
+    }
+
+    if (best < 0) {
+        if (*count == 0 && solution)
+            memcpy(solution, s->grid, sizeof(s->grid));
+        (*count)++;
+        return;
+    }
+
+    while (best_mask && *count < limit && !s->aborted) {
+        unsigned int bit = best_mask & (~best_mask + 1);
+        best_mask &= ~bit;
+        solver_place(s, best, bit_digit(bit));
+        solver_search(s, limit, count, solution);
+        solver_remove(s, best);
+    }
+}
+
+/**
+ * @brief Liczy rozwiązania planszy (do limitu) w ramach budżetu.
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @param limit Maksymalna liczba szukanych rozwiązań.
+ * @param solution Tablica na pierwsze rozwiązanie lub NULL.
+ * @param budget Budżet przeszukiwania (uzupełniane są pola nodes i aborted) lub NULL.
+ * @return Liczba znalezionych rozwiązań; po przerwaniu tylko tych znalezionych wcześniej.
+ */
+int count_solutions_budget(const int grid[9][9], int limit, int solution[9][9], struct SolverBudget* budget)
+{
+    struct Solver s;
+    if (budget) {
+        budget->nodes = 0;
+        budget->aborted = false;
+    }
+    if (!solver_init(&s, grid))
+        return 0;
+    s.budget = budget;
+    int count = 0;
+    solver_search(&s, limit, &count, solution ? &solution[0][0] : NULL);
+    if (budget) {
+        budget->nodes = s.nodes;
+        budget->aborted = s.aborted;
+    }
+    return count;
+}
+
+/**
+ * @brief Liczy rozwiązania planszy (do limitu).
+ *
+ * @param grid Plansza (0 – pusta komórka).
+ * @param limit Maksymalna liczba szukanych rozwiązań (2 wystarcza do sprawdzenia jednoznaczności).
+ * @param solution Tablica na pierwsze rozwiązanie lub NULL.
+ * @return Liczba znalezionych rozwiązań (0 – brak rozwiązania).
+ */
+int count_solutions(const int grid[9][9], int limit, int solution[9][9])
+{
+    return count_solutions_budget(grid, limit, solution, NULL);
+}
+
+#endif
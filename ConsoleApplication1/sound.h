@@ -6,6 +6,7 @@
 #include <allegro5/allegro5.h>
 #include <time.h>
 #include "define.h"
+#include "assets.h"
 #include <string.h>
 
 #ifndef SOUND
@@ -14,87 +15,103 @@
 #include <allegro5/allegro_acodec.h>
 
 /**
- * @var ALLEGRO_SAMPLE* song
- * @brief Wskaźnik na aktualny próbkę dźwięku.
+ * @var ALLEGRO_AUDIO_STREAM* songStream
+ * @brief Strumień aktualnego utworu (dekodowany fragmentami w trakcie odtwarzania).
  */
-ALLEGRO_SAMPLE* song = NULL;
+ALLEGRO_AUDIO_STREAM* songStream = NULL;
 
 /**
- * @var ALLEGRO_SAMPLE_INSTANCE* songInstance
- * @brief Wskaźnik na instancję próbki dźwięku.
+ * @brief Liczba buforów strumienia utworu.
  */
-ALLEGRO_SAMPLE_INSTANCE* songInstance = NULL;
+#define SONG_BUFFERS 4
 
 /**
- * @var char* songs[]
- * @brief Tablica ścieżek do plików dźwiękowych.
+ * @brief Liczba próbek w buforze strumienia utworu.
  */
-char* songs[] = {
-    "23.Upgrade_Station.ogg",
-    "IGGY_WALK.ogg",
-    "JoJo's Bizarre Adventure_ Diamond is Unbreakable OST - The Stardust Man Appears.ogg", 
-    "JoJo's Bizarre Adventure_ Stardust Crusaders OST - Setting Off.ogg",
-    "OST Stardust Crusaders [World] Track 19 - Travelers Who Rest.ogg", 
-};
+#define SONG_BUFFER_SAMPLES 2048
 
 /**
- * @var int len_song
- * @brief Liczba plików dźwiękowych.
+ * @brief Katalog utworów w archiwum zasobów.
  */
-int len_song = sizeof(songs) / sizeof(*songs);
+#define SONGS_DIR "sounds/songs/"
 
 /**
- * @brief Wybiera losowy utwór dźwiękowy i odtwarza go.
+ * @brief Wybiera losowy utwór dźwiękowy spośród zasobów katalogu SONGS_DIR.
  *
- * Funkcja losowo wybiera jeden z dostępnych utworów dźwiękowych,
- * ładuje go i rozpoczyna odtwarzanie. Przy tym zwalniane są zasoby
- * poprzedniego utworu.
+ * Ustawia nameSong na nazwę utworu (bez rozszerzenia).
+ *
+ * @return Identyfikator zasobu utworu.
  */
-void rand_sound() {
+enum AssetId rand_song(void) {
+    // Utwory z manifestu zasobów
+    enum AssetId songs[ASSET_COUNT];
+    int len_song = 0;
+    for (int i = 0; i < ASSET_COUNT; i++)
+        if (strncmp(asset_path(i), SONGS_DIR, strlen(SONGS_DIR)) == 0)
+            songs[len_song++] = (enum AssetId)i;
+
     // Wybór losowego utworu
-    int numSong = rand() % len_song;
+    enum AssetId numSong = songs[rand() % len_song];
 
-    // Kopiowanie ścieżki do wybranego utworu do nameSong
-    strcpy(nameSong, songs[numSong]);
+    // Kopiowanie nazwy wybranego utworu do nameSong
+    snprintf(nameSong, sizeof(nameSong), "%s", asset_path(numSong) + strlen(SONGS_DIR));
     int len = strlen(nameSong);
     if (len > 4)
         nameSong[len - 4] = '\0';
-        
-    // Tworzenie pełnej ścieżki do pliku
-    char path[256];
-    snprintf(path, sizeof(path), "sounds/songs/%s", songs[numSong]);
-
-    // Ładowanie nowego pliku dźwiękowego
-    ALLEGRO_SAMPLE* new_song = al_load_sample(path);
-    if (!new_song) {
-        fprintf(stderr, "Nie udało się załadować utworu: %s\n", path);
+    return numSong;
+}
+
+/**
+ * @brief Otwiera strumień utworu.
+ *
+ * @param id Identyfikator zasobu utworu.
+ * @return Strumień (jeszcze niepodłączony do miksera).
+ */
+ALLEGRO_AUDIO_STREAM* open_song(enum AssetId id) {
+    ALLEGRO_AUDIO_STREAM* stream = al_load_audio_stream(asset_path(id), SONG_BUFFERS, SONG_BUFFER_SAMPLES);
+    if (!stream) {
+        fprintf(stderr, "Nie udało się załadować utworu: %s\n", asset_path(id));
         exit(-5);
     }
+    return stream;
+}
 
+/**
+ * @brief Odtwarza otwarty utwór w miejsce poprzedniego.
+ *
+ * @param new_song Strumień utworu (przechodzi na własność modułu dźwięku).
+ */
+void play_song(ALLEGRO_AUDIO_STREAM* new_song) {
     // Zwalnianie zasobów poprzedniego utworu
-    if (songInstance) {
-        al_destroy_sample_instance(songInstance);
-    }
-    if (song) {
-        al_destroy_sample(song);
+    if (songStream) {
+        al_destroy_audio_stream(songStream);
     }
 
-    // Ustawienie nowego utworu
-    song = new_song;
-    songInstance = al_create_sample_instance(song);
-
     // Konfiguracja i odtwarzanie utworu
-    al_set_sample_instance_playmode(songInstance, ALLEGRO_PLAYMODE_ONCE);
-    al_set_sample_instance_gain(songInstance, volume);
-    al_attach_sample_instance_to_mixer(songInstance, al_get_default_mixer());
-    al_play_sample_instance(songInstance);
+    songStream = new_song;
+    al_set_audio_stream_playmode(songStream, ALLEGRO_PLAYMODE_ONCE);
+    al_set_audio_stream_gain(songStream, volume);
+    al_attach_audio_stream_to_mixer(songStream, al_get_default_mixer());
+    al_set_audio_stream_playing(songStream, true);
+}
+
+/**
+ * @brief Wybiera losowy utwór dźwiękowy i odtwarza go.
+ *
+ * Funkcja losowo wybiera jeden z dostępnych utworów dźwiękowych,
+ * ładuje go i rozpoczyna odtwarzanie. Przy tym zwalniane są zasoby
+ * poprzedniego utworu.
+ */
+void rand_sound() {
+    // Otwarcie strumienia nowego pliku dźwiękowego
+    play_song(open_song(rand_song()));
 }
 
 /**
  * @brief Inicjalizacja obsługi dźwięku.
  *
- * Funkcja rezerwuje sloty dla próbek dźwiękowych, inicjalizuje generator liczb
- * losowych i losowo wybiera oraz odtwarza jeden z dostępnych utworów.
+ * Funkcja rezerwuje sloty dla próbek dźwiękowych i inicjalizuje generator liczb
+ * losowych. Pierwszy utwór wczytuje w tle moduł loader.h.
  */
 void init_sound() {
     // Rezerwacja 4 slotów dla próbek dźwiękowych
@@ -102,9 +119,6 @@ void init_sound() {
 
     // Inicjalizacja generatora liczb losowych
     srand(time(NULL));
-
-    // Losowe odtwarzanie muzyki w tle
-    rand_sound();
 }
 
 /**
@@ -114,8 +128,8 @@ void init_sound() {
  * wybierany jest i odtwarzany nowy losowy utwór.
  */
 void check_song_finished() {
-    // Sprawdzenie, czy aktualny utwór się zakończył
-    if (!al_get_sample_instance_playing(songInstance)) {
+    // Sprawdzenie, czy aktualny utwór się zakończył (pierwszy może być jeszcze wczytywany)
+    if (songStream && !al_get_audio_stream_playing(songStream)) {
         rand_sound();
     }
 }
@@ -0,0 +1,236 @@
+/**
+ * @file stats.h
+ * @brief Statystyki rozegranych gier.
+ *
+ * Wynik każdej zakończonej gry jest dopisywany do dziennika results.log jako
+ * 8-bajtowy rekord binarny. Plik stats.dat przechowuje zagregowane dane dla każdego
+ * poziomu trudności (liczba gier, wygrane, najlepszy i średni czas oraz histogram czasów
+ * do wyznaczania percentyli). Agregaty są aktualizowane w O(1) na grę, więc ekran
+ * statystyk nie musi czytać dziennika.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef STATS
+#define STATS
+
+/**
+ * @brief Nazwa pliku dziennika wyników.
+ */
+#define STATS_LOG_FILE "results.log"
+
+/**
+ * @brief Nazwa pliku agregatów.
+ */
+#define STATS_FILE "stats.dat"
+
+/**
+ * @brief Znacznik pliku agregatów ("SDKS").
+ */
+#define STATS_MAGIC 0x534B4453u
+
+/**
+ * @brief Wersja formatu pliku agregatów.
+ */
+#define STATS_VERSION 1u
+
+/**
+ * @brief Liczba poziomów trudności (łatwy, średni, trudny, inny).
+ */
+#define DIFFICULT_LEVELS 4
+
+/**
+ * @brief Liczba przedziałów histogramu czasów (4 przedziały na każdą potęgę dwójki).
+ */
+#define STATS_BUCKETS 64
+
+/**
+ * @brief Nazwy poziomów trudności.
+ */
+const char* difficult_names[DIFFICULT_LEVELS] = { "Easy", "Mid", "Hard", "Custom" };
+
+/**
+ * @struct GameResult
+ * @brief Rekord dziennika wyników jednej gry (8 bajtów).
+ */
+struct GameResult {
+    uint32_t time_count;    ///< Czas gry w sekundach.
+    uint8_t level;          ///< Poziom trudności (indeks w difficult_names).
+    uint8_t hearts;         ///< Liczba pozostałych serc.
+    uint8_t clues_used;     ///< Liczba wykorzystanych wskazówek.
+    uint8_t win;            ///< 1 – wygrana, 0 – przegrana.
+};
+
+/**
+ * @struct LevelStats
+ * @brief Agregaty wyników dla jednego poziomu trudności.
+ *
+ * Czasy (najlepszy, średni, histogram) liczone są tylko dla wygranych gier.
+ */
+struct LevelStats {
+    uint32_t games;                     ///< Liczba rozegranych gier.
+    uint32_t wins;                      ///< Liczba wygranych gier.
+    uint32_t best_time;                 ///< Najlepszy czas wygranej.
+    uint64_t sum_time;                  ///< Suma czasów wygranych (do średniej).
+    uint32_t hist[STATS_BUCKETS];       ///< Histogram czasów wygranych.
+};
+
+/**
+ * @struct Stats
+ * @brief Zawartość pliku agregatów.
+ */
+struct Stats {
+    uint32_t magic;                             ///< Znacznik pliku.
+    uint32_t version;                           ///< Wersja formatu.
+    struct LevelStats level[DIFFICULT_LEVELS];  ///< Agregaty dla poziomów trudności.
+};
+
+/**
+ * @brief Zwraca indeks poziomu trudności dla tablicy difficult.
+ *
+ * @param difficult Tablica poziomu trudności.
+ * @return Indeks poziomu w difficult_names.
+ */
+int difficult_level(const int difficult[2])
+{
+    if (difficult[0] == 3 && difficult[1] == 4) return 0;
+    if (difficult[0] == 3 && difficult[1] == 5) return 1;
+    if (difficult[0] == 4 && difficult[1] == 6) return 2;
+    return 3;
+}
+
+/**
+ * @brief Wyznacza przedział histogramu dla czasu gry.
+ *
+ * Przedziały są logarytmiczne: 4 na każdą potęgę dwójki, co daje błąd względny
+ * percentyla poniżej 25% przy stałym rozmiarze agregatu.
+ *
+ * @param time_count Czas gry w sekundach.
+ * @return Numer przedziału.
+ */
+int stats_bucket(uint32_t time_count)
+{
+    uint32_t v = time_count + 1;
+    int e = 0;
+    while (v >> (e + 1))
+        e++;
+    int frac = e >= 2 ? (v >> (e - 2)) & 3 : (v << (2 - e)) & 3;
+    int bucket = e * 4 + frac;
+    return bucket < STATS_BUCKETS ? bucket : STATS_BUCKETS - 1;
+}
+
+/**
+ * @brief Zwraca dolną granicę czasu dla przedziału histogramu.
+ *
+ * @param bucket Numer przedziału.
+ * @return Czas w sekundach.
+ */
+uint32_t stats_bucket_time(int bucket)
+{
+    int e = bucket / 4;
+    uint32_t v = (uint32_t)(((uint64_t)(4 + bucket % 4) << e) >> 2);
+    return v > 0 ? v - 1 : 0;
+}
+
+/**
+ * @brief Wczytuje agregaty statystyk.
+ *
+ * Jeśli plik nie istnieje lub jest uszkodzony, statystyki są zerowane.
+ *
+ * @param stats Struktura, do której zostaną wczytane agregaty.
+ */
+void load_stats(struct Stats* stats)
+{
+    FILE* file = fopen(STATS_FILE, "rb");
+    bool ok = false;
+    if (file) {
+        ok = fread(stats, sizeof(struct Stats), 1, file) == 1
+            && stats->magic == STATS_MAGIC && stats->version == STATS_VERSION;
+        fclose(file);
+    }
+    if (!ok) {
+        memset(stats, 0, sizeof(struct Stats));
+        stats->magic = STATS_MAGIC;
+        stats->version = STATS_VERSION;
+    }
+}
+
+/**
+ * @brief Zapisuje agregaty statystyk.
+ *
+ * @param stats Agregaty do zapisania.
+ * @return true, jeśli zapis powiódł się, w przeciwnym razie false.
+ */
+bool save_stats(const struct Stats* stats)
+{
+    FILE* file = fopen(STATS_FILE, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open stats file for writing.\n");
+        return false;
+    }
+    bool ok = fwrite(stats, sizeof(struct Stats), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Zapisuje wynik gry do dziennika i aktualizuje agregaty.
+ *
+ * @param result Wynik zakończonej gry.
+ */
+void record_result(struct GameResult result)
+{
+    FILE* file = fopen(STATS_LOG_FILE, "ab");
+    if (file) {
+        if (fwrite(&result, sizeof(struct GameResult), 1, file) != 1)
+            fprintf(stderr, "Error writing to results log.\n");
+        fclose(file);
+    }
+    else {
+        fprintf(stderr, "Unable to open results log for writing.\n");
+    }
+
+    struct Stats stats;
+    load_stats(&stats);
+    struct LevelStats* level = &stats.level[result.level % DIFFICULT_LEVELS];
+    level->games++;
+    if (result.win) {
+        if (level->wins == 0 || result.time_count < level->best_time)
+            level->best_time = result.time_count;
+        level->wins++;
+        level->sum_time += result.time_count;
+        level->hist[stats_bucket(result.time_count)]++;
+    }
+    save_stats(&stats);
+}
+
+/**
+ * @brief Szacuje percentyl czasu wygranych z histogramu.
+ *
+ * @param level Agregaty poziomu trudności.
+ * @param percent Percentyl (0-100).
+ * @return Przybliżony czas w sekundach lub 0, jeśli brak wygranych.
+ */
+uint32_t stats_percentile(const struct LevelStats* level, int percent)
+{
+    if (level->wins == 0)
+        return 0;
+    uint64_t rank = ((uint64_t)level->wins * percent + 99) / 100;
+    if (rank == 0)
+        rank = 1;
+    uint64_t count = 0;
+    int bucket = STATS_BUCKETS - 1;
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        count += level->hist[i];
+        if (count >= rank) {
+            bucket = i;
+            break;
+        }
+    }
+    uint32_t time = stats_bucket_time(bucket);
+    return time > level->best_time ? time : level->best_time;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file stopwatch.h
+ * @brief Zegar gry liczony z monotonicznego zegara Allegro.
+ *
+ * Czas gry nie jest zliczany z taktów zegara zdarzeń, tylko wyznaczany jako różnica
+ * odczytów al_get_time (zegar monotoniczny o wysokiej rozdzielczości), więc nie
+ * gubi czasu, gdy zdarzenia czekają w kolejce, i ma dokładność milisekund.
+ *
+ * Zegar może być wstrzymany z kilku niezależnych powodów naraz (ustawienia, utrata
+ * fokusu okna, koniec gry, generowanie planszy); biegnie tylko wtedy, gdy żaden z nich nie jest aktywny.
+ */
+
+#include <stdbool.h>
+
+#include <allegro5/allegro5.h>
+
+#ifndef STOPWATCH
+#define STOPWATCH
+
+/**
+ * @brief Powody wstrzymania zegara gry (maska bitowa).
+ */
+enum StopwatchHold {
+    HOLD_SETTING = 1,       ///< Otwarte ustawienia.
+    HOLD_FOCUS = 2,         ///< Okno straciło fokus lub jest zminimalizowane.
+    HOLD_END = 4,           ///< Gra zakończona.
+    HOLD_BOARD = 8          ///< Plansza jest jeszcze generowana.
+};
+
+/**
+ * @struct Stopwatch
+ * @brief Zegar gry.
+ */
+struct Stopwatch {
+    double started;         ///< Odczyt al_get_time przy ostatnim wznowieniu.
+    unsigned int base_ms;   ///< Czas zliczony przed ostatnim wznowieniem.
+    unsigned int holds;     ///< Aktywne powody wstrzymania (enum StopwatchHold).
+};
+
+/**
+ * @brief Ustawia czas zegara i uruchamia go (wszystkie wstrzymania są zdejmowane).
+ *
+ * @param watch Zegar.
+ * @param ms Początkowy czas w milisekundach (np. z zapisu).
+ */
+void stopwatch_reset(struct Stopwatch* watch, unsigned int ms)
+{
+    watch->base_ms = ms;
+    watch->holds = 0;
+    watch->started = al_get_time();
+}
+
+/**
+ * @brief Zwraca czas zegara.
+ *
+ * @param watch Zegar.
+ * @return Czas gry w milisekundach.
+ */
+unsigned int stopwatch_ms(const struct Stopwatch* watch)
+{
+    if (watch->holds)
+        return watch->base_ms;
+    return watch->base_ms + (unsigned int)((al_get_time() - watch->started) * 1000.0);
+}
+
+/**
+ * @brief Wstrzymuje zegar z danego powodu.
+ *
+ * @param watch Zegar.
+ * @param hold Powód wstrzymania.
+ */
+void stopwatch_hold(struct Stopwatch* watch, enum StopwatchHold hold)
+{
+    if (!watch->holds)
+        watch->base_ms = stopwatch_ms(watch);
+    watch->holds |= hold;
+}
+
+/**
+ * @brief Zdejmuje powód wstrzymania; zegar rusza, gdy nie zostaje żaden inny.
+ *
+ * @param watch Zegar.
+ * @param hold Powód wstrzymania.
+ */
+void stopwatch_release(struct Stopwatch* watch, enum StopwatchHold hold)
+{
+    if (!(watch->holds & hold))
+        return;
+    watch->holds &= ~(unsigned int)hold;
+    if (!watch->holds)
+        watch->started = al_get_time();
+}
+
+#endif
@@ -3,64 +3,84 @@
  * @brief Deklaracja struktur używanych w grze Sudoku.
  */
 
+#include "journal.h"
+
 #ifndef STRUCTS
 #define STRUCTS
 
 /**
- * @struct OBJECT
- * @brief Globalna struktura dla obiektów.
+ * @brief Liczba slotów zapisu gry.
+ */
+#define SAVE_SLOTS 5
+
+/**
+ * @struct GameState
+ * @brief Struktura do przechowywania stanu gry.
  *
- * Struktura reprezentująca obiekt z obrazem, rozmiarem i pozycją oraz wskaźnikiem na funkcję wyświetlającą.
+ * Struktura przechowująca aktualny stan gry, w tym planszę gry, wskazówki, serca i czas gry.
  */
-struct OBJECT
-{
-    char name_file[50];     ///< Ścieżka do obrazu.
-    float width;            ///< Szerokość przycisku.
-    float height;           ///< Wysokość przycisku.
-    float x;                ///< Współrzędna x obiektu.
-    float y;                ///< Współrzędna y obiektu.
-    void (*show)(char*, float, float, int, int);  ///< Wskaźnik na funkcję wyświetlającą.
+struct GameState {
+    int matrix_area[9][9]; ///< Plansza gry.
+    int hints;             ///< Liczba wskazówek.
+    int hearts;            ///< Liczba serc.
+    unsigned int time_ms;  ///< Czas gry w milisekundach.
+    // Dodaj inne zmienne do przechowywania
 };
 
 /**
- * @struct CELL
- * @brief Struktura dla komórek.
+ * @struct GameStateV1
+ * @brief Stan gry w zapisach z wersji 1 (czas w sekundach, osobno minuty i sekundy).
  *
- * Struktura reprezentująca komórkę na planszy gry, dziedzicząca właściwości z OBJECT.
+ * Używana tylko do wczytania starszych zapisów.
  */
-struct CELL
-{
-    struct OBJECT;   ///< Dziedziczenie właściwości z OBJECT.
-    int rows;        ///< Indeks wiersza.
-    int column;      ///< Indeks kolumny.
+struct GameStateV1 {
+    int matrix_area[9][9]; ///< Plansza gry.
+    int hints;             ///< Liczba wskazówek.
+    int hearts;            ///< Liczba serc.
+    unsigned int minutes;  ///< Liczba minut gry.
+    unsigned int seconds;  ///< Liczba sekund gry.
+    unsigned int time_count; ///< Czas gry w sekundach.
 };
 
 /**
- * @struct NUMPAD
- * @brief Struktura dla przycisków numerycznych.
+ * @struct SlotInfo
+ * @brief Metadane jednego slotu zapisu.
  *
- * Struktura reprezentująca przycisk numeryczny na klawiaturze numerycznej, dziedzicząca właściwości z OBJECT.
+ * Przechowywane w pliku indeksu, dzięki czemu menu może wyświetlić listę slotów
+ * bez otwierania pełnych zapisów.
  */
-struct NUMPAD
-{
-    struct OBJECT;  ///< Dziedziczenie właściwości z OBJECT.
-    int num;        ///< Numer przycisku.
+struct SlotInfo {
+    int used;                   ///< Czy slot zawiera zapis (0/1).
+    int difficult[2];           ///< Poziom trudności gry zapisanej w slocie.
+    unsigned int time_ms;       ///< Czas gry w milisekundach.
+    int filled;                 ///< Liczba wypełnionych komórek planszy.
+    long long last_played;      ///< Czas ostatniej gry (time(NULL)).
 };
 
 /**
- * @struct GameState
- * @brief Struktura do przechowywania stanu gry.
+ * @struct SaveIndex
+ * @brief Plik indeksu slotów zapisu.
+ */
+struct SaveIndex {
+    unsigned int magic;                     ///< Znacznik pliku indeksu.
+    unsigned int version;                   ///< Wersja formatu.
+    struct SlotInfo slots[SAVE_SLOTS];      ///< Metadane slotów.
+};
+
+/**
+ * @struct SaveExtra
+ * @brief Dodatkowa część pliku slotu zapisywana po GameState.
  *
- * Struktura przechowująca aktualny stan gry, w tym planszę gry, wskazówki, serca i czas gry.
+ * Zapisy bez tej części (starsze wersje gry) wczytują się z pustymi notatkami i dziennikiem.
+ * Wersja 1 kończy się na dzienniku (bez zaimportowanej planszy).
  */
-struct GameState {
-    int matrix_area[9][9]; ///< Plansza gry.
-    int hints;             ///< Liczba wskazówek.
-    int hearts;            ///< Liczba serc.
-    unsigned int minutes;  ///< Liczba minut gry.
-    unsigned int seconds;  ///< Liczba sekund gry.
-    unsigned int time_count; ///< Licznik czasu gry.
-    // Dodaj inne zmienne do przechowywania
+struct SaveExtra {
+    unsigned int magic;             ///< Znacznik części dodatkowej.
+    unsigned int version;           ///< Wersja formatu.
+    unsigned short notes[81];       ///< Notatki komórek.
+    struct Journal journal;         ///< Dziennik cofania i ponawiania.
+    int has_board;                  ///< Czy gra toczy się na zaimportowanej planszy (0/1).
+    int board[9][9];                ///< Cyfry początkowe zaimportowanej planszy (dla restartu).
 };
 
 #endif
@@ -0,0 +1,78 @@
+/**
+ * @file puzzleio_test.c
+ * @brief Test czytnika plansz (puzzleio.h): błędne linie nie przesuwają kolejnych plansz.
+ *
+ * Budowanie i uruchomienie z katalogu ConsoleApplication1:
+ * - MSVC: cl /I. tests\puzzleio_test.c && puzzleio_test.exe
+ * - gcc: gcc -I. tests/puzzleio_test.c -o puzzleio_test && ./puzzleio_test
+ */
+
+#include <stdio.h>
+
+#include "puzzleio.h"
+
+/**
+ * @brief Plik testowy: plansze poprzeplatane nagłówkami, komentarzami i błędnymi liniami.
+ */
+static const char* test_file =
+    "# comment\n"
+    "Grid 01\n"
+    "1...............................................................................9\n"
+    "123456789\n"                                   // Obcięta linia: 9 komórek bez reszty planszy SDK
+    "2...............................................................................8 rating 3.4\n"
+    "12345678901234567890\n"                        // Błędna linia (20 komórek)
+    "Grid 02\n"
+    "3........\n"
+    ".........\n"
+    ".........\n"
+    "---+---+---\n"
+    ".........\n"
+    ".........\n"
+    ".........\n"
+    ".........\n"
+    ".........\n"
+    "........7\n"
+    "\n"
+    "4.......\r\n"                                  // Za krótka linia z CRLF
+    "5...............................................................................6\r\n";
+
+/**
+ * @brief Oczekiwane plansze: pierwsza i ostatnia komórka.
+ */
+static const int expected[][2] = { { 1, 9 }, { 2, 8 }, { 3, 7 }, { 5, 6 } };
+
+int main(void)
+{
+    const char* path = "puzzleio_test.txt";
+    FILE* file = fopen(path, "wb");
+    if (!file || fputs(test_file, file) == EOF || fclose(file) != 0) {
+        fprintf(stderr, "Unable to write %s.\n", path);
+        return 1;
+    }
+
+    struct PuzzleReader reader;
+    if (!open_puzzles(&reader, path)) {
+        fprintf(stderr, "Unable to open %s.\n", path);
+        return 1;
+    }
+    int count = (int)(sizeof(expected) / sizeof(expected[0]));
+    int grid[9][9];
+    int n = 0;
+    int failed = 0;
+    while (read_puzzle(&reader, grid)) {
+        if (n >= count || grid[0][0] != expected[n][0] || grid[8][8] != expected[n][1]) {
+            fprintf(stderr, "FAIL: puzzle %d starts with %d and ends with %d.\n", n + 1, grid[0][0], grid[8][8]);
+            failed = 1;
+        }
+        n++;
+    }
+    close_puzzles(&reader);
+    remove(path);
+
+    if (n != count) {
+        fprintf(stderr, "FAIL: read %d puzzles, expected %d.\n", n, count);
+        failed = 1;
+    }
+    printf(failed ? "puzzleio_test: FAILED\n" : "puzzleio_test: OK\n");
+    return failed;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file texture.h
+ * @brief Pamięć podręczna tekstur wspólna dla wszystkich ekranów.
+ *
+ * Każdy obraz wczytywany jest raz, przy pierwszym odwołaniu do niego, i dalej
+ * identyfikowany uchwytem – identyfikatorem zasobu z manifestu (assets.h).
+ * Rysowanie widżetu to odczyt bitmapy pod uchwytem zamiast wczytywania pliku
+ * przy każdej klatce.
+ *
+ * Tekstury tworzy i rysuje tylko wątek rysowania (render.h). Wątek logiki pobiera
+ * jedynie uchwyty (texture_handle), a brakująca tekstura jest wczytywana przy
+ * pierwszym rysowaniu.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_image.h>
+
+#include "assets.h"
+#include "layout.h"
+
+#ifndef TEXTURE
+#define TEXTURE
+
+/**
+ * @struct TextureCache
+ * @brief Wczytane tekstury według identyfikatora zasobu.
+ */
+struct TextureCache {
+    ALLEGRO_BITMAP* bitmap[ASSET_COUNT];    ///< Bitmapy (NULL – jeszcze nie wczytana).
+    int width;                              ///< Szerokość okna, dla której wczytywane są tekstury.
+};
+
+/**
+ * @brief Pamięć podręczna tekstur programu.
+ */
+struct TextureCache textures;
+
+/**
+ * @brief Sprawdza, czy tekstura jest już wczytana.
+ *
+ * @param id Identyfikator zasobu obrazu.
+ * @return true, jeśli tekstura jest w pamięci podręcznej.
+ */
+bool texture_loaded(enum AssetId id)
+{
+    return textures.bitmap[id] != NULL;
+}
+
+/**
+ * @brief Dodaje do pamięci podręcznej bitmapę wczytaną poza nią (np. przez loader.h).
+ *
+ * @param id Identyfikator zasobu obrazu.
+ * @param bitmap Bitmapa; od tej chwili należy do pamięci podręcznej.
+ * @return Uchwyt tekstury.
+ */
+int texture_add(enum AssetId id, ALLEGRO_BITMAP* bitmap)
+{
+    if (textures.bitmap[id])
+        al_destroy_bitmap(textures.bitmap[id]);
+    textures.bitmap[id] = bitmap;
+    return id;
+}
+
+/**
+ * @brief Zwraca uchwyt tekstury bez wczytywania jej (wątek logiki).
+ *
+ * @param id Identyfikator zasobu obrazu.
+ * @return Uchwyt tekstury.
+ */
+int texture_handle(enum AssetId id)
+{
+    return id;
+}
+
+/**
+ * @brief Zwraca uchwyt tekstury, wczytując ją przy pierwszym odwołaniu.
+ *
+ * @param id Identyfikator zasobu obrazu.
+ * @return Uchwyt tekstury.
+ */
+int texture_get(enum AssetId id)
+{
+    if (textures.bitmap[id])
+        return id;
+
+    char sized[256];
+    const char* path = asset_sized_path(id, textures.width, sized, sizeof(sized));
+    ALLEGRO_BITMAP* bitmap = al_load_bitmap(path);
+    if (!bitmap) {
+        fprintf(stderr, "Failed to load image: %s\n", path);
+        exit(-3);
+    }
+    return texture_add(id, bitmap);
+}
+
+/**
+ * @brief Rysuje teksturę przeskalowaną do prostokąta (wczytując ją, jeśli trzeba).
+ *
+ * @param handle Uchwyt tekstury.
+ * @param x Współrzędna x.
+ * @param y Współrzędna y.
+ * @param width Szerokość.
+ * @param height Wysokość.
+ */
+void texture_draw(int handle, float x, float y, float width, float height)
+{
+    ALLEGRO_BITMAP* bitmap = textures.bitmap[texture_get(handle)];
+    al_draw_scaled_bitmap(bitmap, 0, 0, al_get_bitmap_width(bitmap), al_get_bitmap_height(bitmap), x, y, width, height, 0);
+}
+
+/**
+ * @brief Wczytuje ponownie wczytane tekstury w wersji dla nowego rozmiaru okna.
+ *
+ * Nic nie robi, jeśli nie ma obrazów przeskalowanych. Uchwyty się nie zmieniają.
+ *
+ * @param width Nowa szerokość okna.
+ */
+void textures_resize(int width)
+{
+    textures.width = width;
+    if (!assets.sized)
+        return;
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        if (textures.bitmap[i]) {
+            al_destroy_bitmap(textures.bitmap[i]);
+            textures.bitmap[i] = NULL;
+            texture_get(i);
+        }
+    }
+}
+
+/**
+ * @brief Zwalnia wszystkie tekstury.
+ */
+void textures_destroy(void)
+{
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        if (textures.bitmap[i])
+            al_destroy_bitmap(textures.bitmap[i]);
+        textures.bitmap[i] = NULL;
+    }
+}
+
+#endif
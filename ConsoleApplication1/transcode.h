@@ -0,0 +1,350 @@
+/**
+ * @file transcode.h
+ * @brief Przygotowanie obrazów w rozmiarze rysowania i raport rozmiaru oraz czasu dekodowania.
+ *
+ * Polecenie: --transcode <katalog> [<raport.csv>]
+ *
+ * Dla każdej rozdzielczości z tablicy resolution wylicza układ ekranów (layout.h)
+ * i skaluje każdy obraz do największego prostokąta, w którym jest rysowany. Wynik
+ * zapisuje w kilku formatach, mierzy czas ich dekodowania i zostawia najmniejszy
+ * plik spośród tych, które dekodują się najwyżej TRANSCODE_SLACK razy wolniej od
+ * najszybszego. Pliki trafiają do <katalog>/ASSETS_SIZED_DIR/<szerokość>/ (skąd
+ * pakuje je --pack-assets); pliki nowsze od oryginału nie są tworzone ponownie.
+ *
+ * Muzyka jest odtwarzana jako strumień (sound.h), więc raport porównuje dla niej
+ * pełne dekodowanie pliku z otwarciem strumienia.
+ *
+ * Raport CSV: zasób, rozdzielczość, wymiary, format, rozmiar i czas dekodowania
+ * oryginału oraz wersji przetworzonej.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_image.h>
+#include <allegro5/allegro_audio.h>
+#include <allegro5/allegro_acodec.h>
+
+#include "define.h"
+#include "layout.h"
+#include "assets.h"
+#include "sound.h"
+
+#ifndef TRANSCODE
+#define TRANSCODE
+
+/**
+ * @brief Liczba pomiarów czasu dekodowania (brane jest minimum).
+ */
+#define TRANSCODE_RUNS 5
+
+/**
+ * @brief Dopuszczalne spowolnienie dekodowania względem najszybszego formatu w zamian za mniejszy plik.
+ */
+#define TRANSCODE_SLACK 1.25
+
+/**
+ * @brief Zwraca rozmiar rysowania obrazu: największy z prostokątów, w których jest rysowany.
+ *
+ * @param id Zasób obrazu.
+ * @param L Układ dla rozdzielczości.
+ * @param width Szerokość w pikselach.
+ * @param height Wysokość w pikselach.
+ * @return false dla obrazu, który nie jest rysowany.
+ */
+static bool transcode_target(enum AssetId id, const struct Layout* L, int* width, int* height)
+{
+    struct Rect r[2];
+    int n = 0;
+    switch (id) {
+    case ASSET_MENU_BG:
+    case ASSET_BACKGROUND: r[n++] = (struct Rect){ 0, 0, (float)L->width, (float)L->height }; break;
+    case ASSET_START: r[n++] = L->menu[MENU_START]; break;
+    case ASSET_CONTINUE: r[n++] = L->menu[MENU_CONTINUE]; break;
+    case ASSET_EASY: r[n++] = L->menu[MENU_EASY]; break;
+    case ASSET_MID: r[n++] = L->menu[MENU_MID]; break;
+    case ASSET_HARD: r[n++] = L->menu[MENU_HARD]; break;
+    case ASSET_LEFT_ARROW: r[n++] = L->menu[MENU_BACK]; r[n++] = L->setting[SETTING_LEFT]; break;
+    case ASSET_NUMBERS_FRAME: r[n++] = L->frames[0]; break;
+    case ASSET_CLUE: r[n++] = L->game[BUTTON_CLUE]; break;
+    case ASSET_ICON_SETTING: r[n++] = L->game[BUTTON_SETTING]; break;
+    case ASSET_EXIT: r[n++] = L->game[BUTTON_EXIT]; r[n++] = L->game[BUTTON_EXIT_BOX]; break;
+    case ASSET_HEART: r[n++] = L->game[BUTTON_HEART]; break;
+    case ASSET_RESULT_BOX: r[n++] = L->game[BUTTON_RESULT]; break;
+    case ASSET_RESTART: r[n++] = L->game[BUTTON_RESTART]; break;
+    case ASSET_SETTING: r[n++] = L->panel; break;
+    case ASSET_ACCEPT: r[n++] = L->setting[SETTING_ACCEPT]; break;
+    case ASSET_CANCEL: r[n++] = L->setting[SETTING_CANCEL]; break;
+    case ASSET_RIGHT_ARROW: r[n++] = L->setting[SETTING_RIGHT]; break;
+    case ASSET_SLIDERBACKGROUND: r[n++] = L->setting[SETTING_TRACK]; break;
+    case ASSET_SLIDER: r[n++] = L->setting[SETTING_SLIDER]; break;
+    default:
+        // Cyfry: komórka planszy i klawiatura numeryczna
+        for (int d = 0; d < 9; d++) {
+            if (asset_digits[d] == id) {
+                r[n++] = L->digits[0];
+                r[n++] = L->game[BUTTON_NUMPAD];
+            }
+        }
+        break;
+    }
+    if (n == 0)
+        return false;
+    float w = 0, h = 0;
+    for (int i = 0; i < n; i++) {
+        w = r[i].width > w ? r[i].width : w;
+        h = r[i].height > h ? r[i].height : h;
+    }
+    *width = (int)(w + 0.999f);
+    *height = (int)(h + 0.999f);
+    return *width > 0 && *height > 0;
+}
+
+/**
+ * @brief Zwraca rozmiar pliku w bajtach lub -1.
+ */
+static long long transcode_file_size(const char* path)
+{
+    ALLEGRO_FS_ENTRY* entry = al_create_fs_entry(path);
+    long long size = entry && al_fs_entry_exists(entry) ? (long long)al_get_fs_entry_size(entry) : -1;
+    if (entry)
+        al_destroy_fs_entry(entry);
+    return size;
+}
+
+/**
+ * @brief Zwraca czas modyfikacji pliku lub 0.
+ */
+static time_t transcode_file_time(const char* path)
+{
+    ALLEGRO_FS_ENTRY* entry = al_create_fs_entry(path);
+    time_t mtime = entry && al_fs_entry_exists(entry) ? al_get_fs_entry_mtime(entry) : 0;
+    if (entry)
+        al_destroy_fs_entry(entry);
+    return mtime;
+}
+
+/**
+ * @brief Mierzy czas dekodowania obrazu do bitmapy w pamięci (najkrótszy z TRANSCODE_RUNS).
+ *
+ * @return Czas w milisekundach lub -1, jeśli obrazu nie da się wczytać.
+ */
+static double transcode_decode_ms(const char* path)
+{
+    double best = -1;
+    for (int i = 0; i < TRANSCODE_RUNS; i++) {
+        double start = al_get_time();
+        ALLEGRO_BITMAP* bitmap = al_load_bitmap(path);
+        double ms = (al_get_time() - start) * 1000.0;
+        if (!bitmap)
+            return -1;
+        al_destroy_bitmap(bitmap);
+        if (best < 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+/**
+ * @brief Skaluje obraz do podanego rozmiaru, zmniejszając go najwyżej dwukrotnie na krok.
+ *
+ * Kanał alfa jest kopiowany bez mieszania, więc obraz źródłowy musi być wczytany
+ * bez przemnożenia przez alfę (zapisany plik zostanie przemnożony przy wczytaniu w grze).
+ */
+static ALLEGRO_BITMAP* transcode_scale(ALLEGRO_BITMAP* source, int width, int height)
+{
+    ALLEGRO_STATE state;
+    al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+    al_set_blender(ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+
+    ALLEGRO_BITMAP* current = source;
+    for (;;) {
+        int cw = al_get_bitmap_width(current), ch = al_get_bitmap_height(current);
+        int nw = cw / 2 > width ? cw / 2 : width;
+        int nh = ch / 2 > height ? ch / 2 : height;
+        ALLEGRO_BITMAP* next = al_create_bitmap(nw, nh);
+        if (!next)
+            break;
+        al_set_target_bitmap(next);
+        al_draw_scaled_bitmap(current, 0, 0, cw, ch, 0, 0, nw, nh, 0);
+        if (current != source)
+            al_destroy_bitmap(current);
+        current = next;
+        if (nw == width && nh == height)
+            break;
+    }
+    al_restore_state(&state);
+    return current != source ? current : NULL;
+}
+
+/**
+ * @brief Wybiera aktualny plik przetworzony (nowszy od oryginału) spośród formatów.
+ *
+ * @return Indeks formatu w asset_sized_formats lub -1.
+ */
+static int transcode_fresh(const char* stem, time_t source_time)
+{
+    char path[1024];
+    for (size_t i = 0; i < sizeof(asset_sized_formats) / sizeof(*asset_sized_formats); i++) {
+        snprintf(path, sizeof(path), "%s%s", stem, asset_sized_formats[i]);
+        if (transcode_file_time(path) >= source_time)
+            return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Zapisuje przeskalowany obraz we wszystkich formatach i zostawia najlepszy.
+ *
+ * @return Indeks wybranego formatu lub -1.
+ */
+static int transcode_encode(ALLEGRO_BITMAP* scaled, const char* stem)
+{
+    const int formats = (int)(sizeof(asset_sized_formats) / sizeof(*asset_sized_formats));
+    double ms[8];
+    long long bytes[8];
+    char path[1024];
+    double fastest = -1;
+    for (int i = 0; i < formats; i++) {
+        snprintf(path, sizeof(path), "%s%s", stem, asset_sized_formats[i]);
+        ms[i] = al_save_bitmap(path, scaled) ? transcode_decode_ms(path) : -1;
+        bytes[i] = transcode_file_size(path);
+        if (ms[i] >= 0 && (fastest < 0 || ms[i] < fastest))
+            fastest = ms[i];
+    }
+    int chosen = -1;
+    for (int i = 0; i < formats; i++)
+        if (ms[i] >= 0 && ms[i] <= fastest * TRANSCODE_SLACK && (chosen < 0 || bytes[i] < bytes[chosen]))
+            chosen = i;
+    for (int i = 0; i < formats; i++) {
+        if (i != chosen) {
+            snprintf(path, sizeof(path), "%s%s", stem, asset_sized_formats[i]);
+            al_remove_filename(path);
+        }
+    }
+    return chosen;
+}
+
+/**
+ * @brief Punkt wejścia przygotowania zasobów (--transcode).
+ *
+ * @param argc Liczba argumentów programu.
+ * @param argv Argumenty programu.
+ * @return Kod wyjścia programu.
+ */
+int transcode_main(int argc, char** argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s --transcode <dir> [<report.csv>]\n", argv[0]);
+        return 1;
+    }
+    al_init_image_addon();
+    al_init_acodec_addon();
+    al_install_audio();
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP | ALLEGRO_MIN_LINEAR | ALLEGRO_MAG_LINEAR);
+
+    const char* dir = argv[2];
+    char path[1024], report_path[1024], stem[1024], out[1024];
+    snprintf(report_path, sizeof(report_path), "%s/transcode_report.csv", dir);
+    FILE* report = fopen(argc > 3 ? argv[3] : report_path, "w");
+    if (!report) {
+        fprintf(stderr, "Unable to open %s for writing.\n", argc > 3 ? argv[3] : report_path);
+        return 1;
+    }
+    fprintf(report, "asset,resolution,width,height,format,original_bytes,original_decode_ms,transcoded_bytes,transcoded_decode_ms\n");
+
+    // Oryginały mierzone raz
+    double original_ms[ASSET_COUNT];
+    long long original_bytes[ASSET_COUNT];
+    for (int id = 0; id < ASSET_COUNT; id++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, asset_path(id));
+        original_bytes[id] = transcode_file_size(path);
+        original_ms[id] = strncmp(asset_path(id), "image/", 6) == 0 ? transcode_decode_ms(path) : -1;
+    }
+
+    bool ok = true;
+    for (int r = 0; r < 3; r++) {
+        struct Layout L;
+        layout_compute(&L, resolution[r][0], resolution[r][1]);
+        long long total_bytes[2] = { 0, 0 };
+        double total_ms[2] = { 0, 0 };
+        for (int id = 0; id < ASSET_COUNT; id++) {
+            int width, height;
+            if (original_ms[id] < 0 || !transcode_target(id, &L, &width, &height))
+                continue;
+            snprintf(path, sizeof(path), "%s/%s", dir, asset_path(id));
+            const char* dot = strrchr(asset_path(id), '.');
+            snprintf(stem, sizeof(stem), "%s/%s/%d/%.*s", dir, ASSETS_SIZED_DIR, L.width,
+                (int)(dot - asset_path(id)), asset_path(id));
+
+            int format = transcode_fresh(stem, transcode_file_time(path));
+            if (format < 0) {
+                ALLEGRO_PATH* parent = al_create_path(stem);
+                al_set_path_filename(parent, NULL);
+                al_make_directory(al_path_cstr(parent, ALLEGRO_NATIVE_PATH_SEP));
+                al_destroy_path(parent);
+
+                ALLEGRO_BITMAP* source = al_load_bitmap_flags(path, ALLEGRO_NO_PREMULTIPLIED_ALPHA);
+                ALLEGRO_BITMAP* scaled = source ? transcode_scale(source, width, height) : NULL;
+                format = scaled ? transcode_encode(scaled, stem) : -1;
+                if (scaled)
+                    al_destroy_bitmap(scaled);
+                if (source)
+                    al_destroy_bitmap(source);
+            }
+            if (format < 0) {
+                fprintf(stderr, "Unable to transcode %s\n", path);
+                ok = false;
+                continue;
+            }
+            snprintf(out, sizeof(out), "%s%s", stem, asset_sized_formats[format]);
+            long long bytes = transcode_file_size(out);
+            double ms = transcode_decode_ms(out);
+            fprintf(report, "%s,%dx%d,%d,%d,%s,%lld,%.3f,%lld,%.3f\n", asset_path(id), L.width, L.height,
+                width, height, asset_sized_formats[format] + 1, original_bytes[id], original_ms[id], bytes, ms);
+            total_bytes[0] += original_bytes[id];
+            total_bytes[1] += bytes;
+            total_ms[0] += original_ms[id];
+            total_ms[1] += ms;
+        }
+        printf("%dx%d: images %lld -> %lld bytes, decode %.1f -> %.1f ms\n", L.width, L.height,
+            total_bytes[0], total_bytes[1], total_ms[0], total_ms[1]);
+    }
+
+    // Muzyka: pełne dekodowanie a otwarcie strumienia
+    double total_ms[2] = { 0, 0 };
+    for (int id = 0; id < ASSET_COUNT; id++) {
+        if (strncmp(asset_path(id), SONGS_DIR, strlen(SONGS_DIR)) != 0)
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, asset_path(id));
+        double start = al_get_time();
+        ALLEGRO_SAMPLE* sample = al_load_sample(path);
+        double full_ms = (al_get_time() - start) * 1000.0;
+        if (sample)
+            al_destroy_sample(sample);
+        start = al_get_time();
+        ALLEGRO_AUDIO_STREAM* stream = al_load_audio_stream(path, SONG_BUFFERS, SONG_BUFFER_SAMPLES);
+        double stream_ms = (al_get_time() - start) * 1000.0;
+        if (stream)
+            al_destroy_audio_stream(stream);
+        if (!sample || !stream) {
+            fprintf(stderr, "Unable to decode %s\n", path);
+            ok = false;
+            continue;
+        }
+        // Nazwa utworu może zawierać przecinki: pole w cudzysłowie
+        fprintf(report, "\"%s\",-,0,0,stream,%lld,%.3f,%lld,%.3f\n", asset_path(id), original_bytes[id], full_ms,
+            original_bytes[id], stream_ms);
+        total_ms[0] += full_ms;
+        total_ms[1] += stream_ms;
+    }
+    printf("Music: full decode %.1f ms -> stream open %.1f ms\n", total_ms[0], total_ms[1]);
+
+    ok = fclose(report) == 0 && ok;
+    return ok ? 0 : 1;
+}
+
+#endif
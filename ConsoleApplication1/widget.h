@@ -0,0 +1,198 @@
+/**
+ * @file widget.h
+ * @brief Trwała tablica widżetów ekranu w układzie struktury tablic.
+ *
+ * Ekran tworzy swoje widżety raz: obrazy (uchwyt tekstury), przyciski tekstowe (napis)
+ * i niewidoczne obszary klikalne. Prostokąty, uchwyty, napisy i flagi leżą w osobnych
+ * tablicach. Jedno przejście rysuje widoczne widżety w kolejności dodania, grupując
+ * kolejne obrazy w jedną partię (al_hold_bitmap_drawing), a jedno zapytanie
+ * hit-testu zwraca indeks widżetu pod kursorem. Tablica trafień jest odbudowywana
+ * tylko po zmianie prostokąta lub widoczności.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <allegro5/allegro5.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_primitives.h>
+
+#include "layout.h"
+#include "hittest.h"
+#include "texture.h"
+
+#ifndef WIDGET
+#define WIDGET
+
+/**
+ * @brief Maksymalna liczba widżetów ekranu (tyle, ile prostokątów tablicy trafień).
+ */
+#define WIDGET_MAX HIT_MAX
+
+/**
+ * @brief Widżet jest rysowany i klikalny.
+ */
+#define WIDGET_VISIBLE 1
+
+/**
+ * @brief Przycisk tekstowy jest włączony (wypełnione tło).
+ */
+#define WIDGET_ACTIVE 2
+
+/**
+ * @struct Widgets
+ * @brief Widżety jednego ekranu.
+ */
+struct Widgets {
+    struct Rect rect[WIDGET_MAX];       ///< Prostokąty.
+    short texture[WIDGET_MAX];          ///< Uchwyt tekstury lub -1.
+    const char* label[WIDGET_MAX];      ///< Napis przycisku tekstowego lub NULL.
+    unsigned char flags[WIDGET_MAX];    ///< WIDGET_VISIBLE, WIDGET_ACTIVE.
+    int count;                          ///< Liczba widżetów.
+    bool dirty;                         ///< Tablica trafień wymaga odbudowania.
+    struct HitTable hits;               ///< Tablica trafień widocznych widżetów.
+};
+
+/**
+ * @brief Usuwa wszystkie widżety.
+ *
+ * @param w Widżety ekranu.
+ */
+void widgets_clear(struct Widgets* w)
+{
+    w->count = 0;
+    w->dirty = true;
+}
+
+/**
+ * @brief Dodaje widżet (widoczny, z pustym prostokątem).
+ */
+static int widget_add(struct Widgets* w, int texture, const char* label)
+{
+    int i = w->count++;
+    w->rect[i] = (struct Rect){ 0, 0, 0, 0 };
+    w->texture[i] = (short)texture;
+    w->label[i] = label;
+    w->flags[i] = WIDGET_VISIBLE;
+    w->dirty = true;
+    return i;
+}
+
+/**
+ * @brief Dodaje widżet-obraz.
+ *
+ * @param w Widżety ekranu.
+ * @param image Identyfikator zasobu obrazu.
+ * @return Indeks widżetu.
+ */
+int widget_image(struct Widgets* w, enum AssetId image)
+{
+    return widget_add(w, texture_handle(image), NULL);
+}
+
+/**
+ * @brief Dodaje przycisk tekstowy (ramka z napisem).
+ *
+ * @param w Widżety ekranu.
+ * @param label Napis (musi istnieć tak długo jak widżet).
+ * @return Indeks widżetu.
+ */
+int widget_text(struct Widgets* w, const char* label)
+{
+    return widget_add(w, -1, label);
+}
+
+/**
+ * @brief Dodaje niewidoczny obszar klikalny.
+ *
+ * @param w Widżety ekranu.
+ * @return Indeks widżetu.
+ */
+int widget_area(struct Widgets* w)
+{
+    return widget_add(w, -1, NULL);
+}
+
+/**
+ * @brief Ustawia prostokąt widżetu.
+ *
+ * @param w Widżety ekranu.
+ * @param i Indeks widżetu.
+ * @param rect Prostokąt.
+ */
+void widget_place(struct Widgets* w, int i, struct Rect rect)
+{
+    w->rect[i] = rect;
+    w->dirty = true;
+}
+
+/**
+ * @brief Ustawia flagę widżetu.
+ *
+ * @param w Widżety ekranu.
+ * @param i Indeks widżetu.
+ * @param flag WIDGET_VISIBLE lub WIDGET_ACTIVE.
+ * @param on Nowa wartość flagi.
+ */
+void widget_set(struct Widgets* w, int i, unsigned char flag, bool on)
+{
+    unsigned char flags = on ? (w->flags[i] | flag) : (w->flags[i] & ~flag);
+    if ((flags ^ w->flags[i]) & WIDGET_VISIBLE)
+        w->dirty = true;
+    w->flags[i] = flags;
+}
+
+/**
+ * @brief Rysuje widoczne widżety w kolejności dodania.
+ *
+ * Kolejne obrazy rysowane są jedną partią; przycisk tekstowy zamyka partię.
+ *
+ * @param w Widżety ekranu.
+ * @param font Czcionka przycisków tekstowych.
+ */
+void widgets_draw(const struct Widgets* w, ALLEGRO_FONT* font)
+{
+    bool held = false;
+    for (int i = 0; i < w->count; i++) {
+        if (!(w->flags[i] & WIDGET_VISIBLE))
+            continue;
+        const struct Rect* r = &w->rect[i];
+        if (w->texture[i] >= 0) {
+            if (!held)
+                al_hold_bitmap_drawing(held = true);
+            texture_draw(w->texture[i], r->x, r->y, r->width, r->height);
+        }
+        else if (w->label[i]) {
+            if (held)
+                al_hold_bitmap_drawing(held = false);
+            if (w->flags[i] & WIDGET_ACTIVE)
+                al_draw_filled_rectangle(r->x, r->y, r->x + r->width, r->y + r->height, al_map_rgb(200, 200, 200));
+            al_draw_rectangle(r->x, r->y, r->x + r->width, r->y + r->height, al_map_rgb(0, 0, 0), 2.0);
+            al_draw_text(font, al_map_rgb(0, 0, 0), r->x + r->width / 2, r->y + (r->height - al_get_font_line_height(font)) / 2, ALLEGRO_ALIGN_CENTRE, w->label[i]);
+        }
+    }
+    if (held)
+        al_hold_bitmap_drawing(false);
+}
+
+/**
+ * @brief Zwraca widżet pod wskazanym punktem.
+ *
+ * @param w Widżety ekranu.
+ * @param x Współrzędna x.
+ * @param y Współrzędna y.
+ * @return Indeks widocznego widżetu (ostatnio dodanego, jeśli kilka się nakłada) lub -1.
+ */
+int widgets_hit(struct Widgets* w, float x, float y)
+{
+    if (w->dirty) {
+        hit_clear(&w->hits, layout.width, layout.height);
+        for (int i = 0; i < w->count; i++)
+            if (w->flags[i] & WIDGET_VISIBLE)
+                hit_add_rect(&w->hits, w->rect[i], i);
+        w->dirty = false;
+    }
+    return hit_test(&w->hits, x, y);
+}
+
+#endif